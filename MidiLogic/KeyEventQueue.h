@@ -0,0 +1,58 @@
+// KeyEventQueue.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include "KeyStates.h"
+
+// Key changes stamped with the time the synth rendered them, so the UI can show
+// them when they are heard rather than when they enter the output buffer.
+// Lock-free with one producer (the player thread) and one consumer (the UI).
+class KeyEventQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Returns false if the queue is full; the caller should then apply the
+    // change directly rather than lose a note-off
+    bool Push(int channel, int keyIndex, bool down) {
+        size_t write = tail.load(std::memory_order_relaxed);
+        if (write - head.load(std::memory_order_acquire) == CAPACITY) return false;
+        events[write % CAPACITY] = {Clock::now(), static_cast<uint8_t>(channel), static_cast<uint8_t>(keyIndex), down};
+        tail.store(write + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Applies every change rendered at or before renderedBy, in order
+    void ApplyDue(KeyStates& keyStates, Clock::time_point renderedBy) {
+        size_t read = head.load(std::memory_order_relaxed);
+        size_t end = tail.load(std::memory_order_acquire);
+        while (read != end && events[read % CAPACITY].time <= renderedBy) {
+            const Event& event = events[read % CAPACITY];
+            keyStates.SetKey(event.channel, event.keyIndex, event.down);
+            ++read;
+        }
+        head.store(read, std::memory_order_release);
+    }
+
+    // Drops pending changes; only the consumer may call this
+    void Discard() {
+        head.store(tail.load(std::memory_order_acquire), std::memory_order_release);
+    }
+
+private:
+    static constexpr size_t CAPACITY = 4096;
+
+    struct Event {
+        Clock::time_point time;
+        uint8_t channel;
+        uint8_t keyIndex;
+        bool down;
+    };
+
+    std::array<Event, CAPACITY> events{};
+    std::atomic<size_t> head{0};
+    std::atomic<size_t> tail{0};
+};
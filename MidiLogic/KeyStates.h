@@ -0,0 +1,71 @@
+// KeyStates.h
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Keys currently held by each MIDI channel, as one 88-bit set per channel.
+// Writers (the FluidSynth player or MIDI driver thread) only do atomic bit
+// operations, so they never block or allocate; the render loop copies a
+// snapshot once per frame.
+class KeyStates {
+public:
+    static constexpr int CHANNELS = 16;
+    static constexpr int KEYS = 88;
+
+    // Union of all channels at one point in time
+    struct Snapshot {
+        std::array<uint64_t, 2> keys{};
+
+        bool IsDown(int keyIndex) const {
+            return (keys[keyIndex >> 6] >> (keyIndex & 63)) & 1u;
+        }
+
+        Snapshot& operator|=(const Snapshot& other) {
+            keys[0] |= other.keys[0];
+            keys[1] |= other.keys[1];
+            return *this;
+        }
+    };
+
+    // keyIndex is the MIDI number - 21
+    void SetKey(int channel, int keyIndex, bool down) {
+        if (channel < 0 || channel >= CHANNELS || keyIndex < 0 || keyIndex >= KEYS) return;
+        uint64_t mask = uint64_t{1} << (keyIndex & 63);
+        std::atomic<uint64_t>& word = bits[channel * 2 + (keyIndex >> 6)];
+        if (down) {
+            word.fetch_or(mask, std::memory_order_release);
+        } else {
+            word.fetch_and(~mask, std::memory_order_release);
+        }
+    }
+
+    bool IsDown(int channel, int keyIndex) const {
+        if (channel < 0 || channel >= CHANNELS || keyIndex < 0 || keyIndex >= KEYS) return false;
+        uint64_t word = bits[channel * 2 + (keyIndex >> 6)].load(std::memory_order_acquire);
+        return (word >> (keyIndex & 63)) & 1u;
+    }
+
+    void ClearChannel(int channel) {
+        if (channel < 0 || channel >= CHANNELS) return;
+        bits[channel * 2].store(0, std::memory_order_release);
+        bits[channel * 2 + 1].store(0, std::memory_order_release);
+    }
+
+    void Clear() {
+        for (auto& word : bits) word.store(0, std::memory_order_release);
+    }
+
+    Snapshot TakeSnapshot() const {
+        Snapshot snapshot;
+        for (int channel = 0; channel < CHANNELS; ++channel) {
+            snapshot.keys[0] |= bits[channel * 2].load(std::memory_order_acquire);
+            snapshot.keys[1] |= bits[channel * 2 + 1].load(std::memory_order_acquire);
+        }
+        return snapshot;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, CHANNELS * 2> bits{};
+};
@@ -1,31 +1,6 @@
 // MidiBlock.cpp
 #include "MidiBlock.h"
 
-#include <vector>
-
-
-std::vector<MidiBlock> midiBlocks;
-
-MidiBlock::MidiBlock(int key, int channel, double startTime, double duration, const MidiColor& color)
-    : key(key), channel(channel), startTime(startTime), duration(duration), color(color) {}
-
-bool MidiBlock::isActive(double currentTime) const {
-    return currentTime >= startTime && currentTime <= (startTime + duration);
-}
-
-float MidiBlock::getY(float keyboardY, float speed, double currentTime) const {
-    // Blocks fall down: higher startTime means higher initial Y
-    // At startTime, block's bottom is at keyboardY
-    // As time increases, block moves down (Y increases)
-    float elapsed = static_cast<float>(currentTime - startTime);
-    return keyboardY - getHeight(speed) + elapsed * speed;
-}
-
-float MidiBlock::getHeight(float speed) const {
-    // Height is proportional to note duration
-    return static_cast<float>(duration * speed);
-}
-
 MidiColor MidiBlock::colorForChannel(int channel) {
     if (channel == 0) {
         // Right hand: #66E5D2 (teal)
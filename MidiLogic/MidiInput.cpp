@@ -0,0 +1,81 @@
+// MidiInput.cpp
+#include "MidiInput.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#define NOTE_OFF 0x80
+#define NOTE_ON  0x90
+
+MidiInput::MidiInput(fluid_settings_t* settings, fluid_synth_t* synth, KeyStates& keyStates,
+                     PlaybackClock& playbackClock, double outputLatencySeconds)
+    : synth(synth), keyStates(keyStates), playbackClock(playbackClock),
+      outputLatencyMs(outputLatencySeconds * 1000.0),
+      // A note waits at most about one buffer and then the whole queue, so twice
+      // the output latency keeps large buffer settings out of the last bucket
+      latency(std::max(50.0, 2.0 * outputLatencySeconds * 1000.0)) {
+    fluid_settings_setstr(settings, "midi.portname", "Sonique");
+    // Connects every hardware input on start; older FluidSynth versions ignore it
+    fluid_settings_setint(settings, "midi.autoconnect", 1);
+    driver = new_fluid_midi_driver(settings, HandleEvent, this);
+    if (driver == nullptr) {
+        std::cerr << "No MIDI input driver available; live input is disabled" << std::endl;
+        return;
+    }
+    playbackClock.SetRenderListener(BufferRendered, this);
+}
+
+MidiInput::~MidiInput() {
+    Close();
+}
+
+void MidiInput::Close() {
+    if (driver == nullptr) return;
+    playbackClock.SetRenderListener(nullptr, nullptr);
+    delete_fluid_midi_driver(driver);
+    driver = nullptr;
+}
+
+int MidiInput::HandleEvent(void* data, fluid_midi_event_t* event) {
+    auto* input = static_cast<MidiInput*>(data);
+    Clock::time_point arrived = Clock::now();
+
+    int type = fluid_midi_event_get_type(event);
+    int channel = fluid_midi_event_get_channel(event);
+    int key = fluid_midi_event_get_key(event);
+    // Played keys light up at once; the player has already heard them
+    if (channel != 9 && key >= 21 && key <= 108) {
+        if (type == NOTE_ON && fluid_midi_event_get_velocity(event) > 0) {
+            input->keyStates.SetKey(channel, key - 21, true);
+        } else if (type == NOTE_OFF || (type == NOTE_ON && fluid_midi_event_get_velocity(event) == 0)) {
+            input->keyStates.SetKey(channel, key - 21, false);
+        }
+    }
+
+    int result = fluid_synth_handle_midi_event(input->synth, event);
+    int idle = PROBE_IDLE;
+    if (type == NOTE_ON && fluid_midi_event_get_velocity(event) > 0 &&
+        input->probeState.compare_exchange_strong(idle, PROBE_WRITING, std::memory_order_acquire)) {
+        input->probeArrived.store(arrived.time_since_epoch().count(), std::memory_order_relaxed);
+        input->probeHandled.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        input->probeState.store(PROBE_READY, std::memory_order_release);
+    }
+    return result;
+}
+
+void MidiInput::BufferRendered(void* data, Clock::time_point started, Clock::time_point finished,
+                               double bufferSeconds) {
+    auto* input = static_cast<MidiInput*>(data);
+    if (input->probeState.load(std::memory_order_acquire) != PROBE_READY) return;
+    // A note the synth only took once this buffer was rendering is heard in the next one
+    Clock::time_point handled{Clock::duration(input->probeHandled.load(std::memory_order_relaxed))};
+    if (handled > started) return;
+
+    Clock::time_point arrived{Clock::duration(input->probeArrived.load(std::memory_order_relaxed))};
+    // The note starts with this buffer, which plays once the buffers queued ahead of it have
+    double waitedMs = std::chrono::duration<double, std::milli>(finished - arrived).count();
+    double queuedMs = std::max(0.0, input->outputLatencyMs - bufferSeconds * 1000.0);
+    input->latency.Record(waitedMs + queuedMs);
+    input->probeState.store(PROBE_IDLE, std::memory_order_release);
+}
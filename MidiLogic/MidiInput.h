@@ -0,0 +1,56 @@
+// MidiInput.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fluidsynth.h>
+#include "KeyStates.h"
+#include "PlaybackClock.h"
+#include "../utils/LatencyHistogram.h"
+
+// Live input from MIDI ports through FluidSynth's MIDI driver (ALSA sequencer
+// on Linux, CoreMIDI on macOS). Events go to the synth and the key display on
+// the driver's own thread, without waiting for the render loop. The driver
+// opens a port called "Sonique" that other software can connect to.
+class MidiInput {
+public:
+    MidiInput(fluid_settings_t* settings, fluid_synth_t* synth, KeyStates& keyStates, PlaybackClock& playbackClock,
+              double outputLatencySeconds);
+    MidiInput(const MidiInput&) = delete;
+    MidiInput& operator=(const MidiInput&) = delete;
+    ~MidiInput();
+
+    bool IsOpen() const { return driver != nullptr; }
+
+    // Must run before the synth is deleted
+    void Close();
+
+    // Time from a note-on arriving to it being heard, measured against the audio
+    // callback: from arrival to the end of the first buffer that started
+    // rendering after the synth had the note, plus the device queue ahead of
+    // that buffer. One note is measured at a time; notes that arrive while one
+    // is in flight are not sampled. Empty when the driver has no render callback.
+    const LatencyHistogram& GetLatencyHistogram() const { return latency; }
+
+private:
+    using Clock = PlaybackClock::Clock;
+
+    fluid_midi_driver_t* driver = nullptr;
+    fluid_synth_t* synth;
+    KeyStates& keyStates;
+    PlaybackClock& playbackClock;
+    double outputLatencyMs;
+    LatencyHistogram latency;
+
+    // The note being measured. probeState is written last by the MIDI thread
+    // and cleared by the audio thread once it has recorded the note.
+    enum ProbeState : int { PROBE_IDLE, PROBE_WRITING, PROBE_READY };
+    std::atomic<int> probeState{PROBE_IDLE};
+    std::atomic<int64_t> probeArrived{0}; // Clock ticks since its epoch
+    std::atomic<int64_t> probeHandled{0};
+
+    static int HandleEvent(void* data, fluid_midi_event_t* event);
+    static void BufferRendered(void* data, Clock::time_point started, Clock::time_point finished,
+                               double bufferSeconds);
+};
@@ -0,0 +1,335 @@
+// MidiParser.cpp
+#include "MidiParser.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <functional>
+#include <queue>
+#include "../utils/ThreadPool.h"
+
+#define NOTE_OFF 0x80
+#define NOTE_ON  0x90
+
+namespace {
+    constexpr uint64_t NO_NOTE = UINT64_MAX;
+
+    uint32_t ReadBigEndian(const uint8_t* p, int bytes) {
+        uint32_t value = 0;
+        for (int i = 0; i < bytes; ++i) value = (value << 8) | p[i];
+        return value;
+    }
+
+    // Cursor over one chunk that never reads past its end
+    struct ByteReader {
+        const uint8_t* pos;
+        const uint8_t* end;
+
+        bool ReadByte(uint8_t& out) {
+            if (pos >= end) return false;
+            out = *pos++;
+            return true;
+        }
+
+        // Variable-length quantities are at most four bytes long
+        bool ReadVarLen(uint32_t& out) {
+            out = 0;
+            for (int i = 0; i < 4; ++i) {
+                uint8_t c;
+                if (!ReadByte(c)) return false;
+                out = (out << 7) | (c & 0x7F);
+                if (!(c & 0x80)) return true;
+            }
+            return false;
+        }
+
+        bool Skip(size_t count) {
+            if (static_cast<size_t>(end - pos) < count) return false;
+            pos += count;
+            return true;
+        }
+    };
+
+    struct TickNote {
+        uint64_t startTick;
+        uint64_t endTick;
+        uint8_t key;
+        uint8_t channel;
+        uint8_t velocity;
+    };
+
+    // Files smaller than this are decoded on the calling thread; handing their
+    // tracks to the pool costs more than it saves
+    constexpr size_t PARALLEL_MIN_BYTES = 64 * 1024;
+
+    // What one MTrk chunk contributes. Tracks only share the tempo map, which
+    // is needed for seconds but not for decoding, so each is decoded alone.
+    struct TrackData {
+        const uint8_t* begin;
+        const uint8_t* end;
+
+        std::vector<TickNote> notes; // Sorted by start tick once decoded
+        std::vector<TempoMap::TempoChange> tempoChanges;
+        std::vector<MidiProgram> programs;
+        std::vector<SeekIndex::ChannelEvent> channelEvents; // What the seek checkpoints restore
+        std::array<uint64_t, 16> firstProgramTick;
+        std::array<uint64_t, 16> firstNoteTick;
+        std::array<uint16_t, 16> firstNoteBank{}; // Bank in effect at firstNoteTick
+        uint16_t channelMask = 0;
+        size_t noteCount = 0;
+        uint64_t endTick = 0;
+
+        std::vector<float> startTimes; // Filled after the tempo map is built
+        std::vector<float> durations;
+    };
+
+    void DecodeTrack(TrackData& track, const MidiParseOptions& options) {
+        std::array<uint64_t, 16 * 128> noteOnTicks; // channel * 128 + key -> tick of the open note
+        std::array<uint8_t, 16 * 128> noteOnVelocities;
+        std::array<uint16_t, 16> banks{};           // Last bank select per channel
+        noteOnTicks.fill(NO_NOTE);
+        track.firstProgramTick.fill(NO_NOTE);
+        track.firstNoteTick.fill(NO_NOTE);
+
+        ByteReader reader{track.begin, track.end};
+        uint8_t runningStatus = 0;
+        uint64_t absTicks = 0;
+
+        while (reader.pos < reader.end) {
+            uint32_t delta;
+            uint8_t status;
+            if (!reader.ReadVarLen(delta) || !reader.ReadByte(status)) break;
+            absTicks += delta;
+            if (absTicks > options.maxTick) {
+                absTicks = options.maxTick;
+                break;
+            }
+
+            if (status < 0x80) {
+                if (runningStatus == 0) break; // Data byte without a status to repeat
+                --reader.pos;
+                status = runningStatus;
+            } else if (status < 0xF0) {
+                runningStatus = status;
+            }
+
+            if (status == 0xFF) {
+                uint8_t metaType;
+                uint32_t length;
+                if (!reader.ReadByte(metaType) || !reader.ReadVarLen(length)) break;
+                if (metaType == 0x51 && length == 3 && reader.end - reader.pos >= 3) {
+                    track.tempoChanges.push_back({absTicks, ReadBigEndian(reader.pos, 3)});
+                }
+                if (!reader.Skip(length) || metaType == 0x2F) break;
+                runningStatus = 0;
+                continue;
+            }
+            if (status == 0xF0 || status == 0xF7) {
+                uint32_t length;
+                if (!reader.ReadVarLen(length) || !reader.Skip(length)) break;
+                runningStatus = 0;
+                continue;
+            }
+            if (status > 0xF0) break; // System common/real-time messages are not valid in a file
+
+            uint8_t type = status & 0xF0;
+            uint8_t channel = status & 0x0F;
+            uint8_t key;
+            uint8_t velocity = 0;
+            if (!reader.ReadByte(key)) break;
+            if (type != 0xC0 && type != 0xD0 && !reader.ReadByte(velocity)) break;
+            if (type == 0xB0 && key == 0) banks[channel] = velocity;
+            if (type == 0xC0) {
+                track.programs.push_back({channel == 9 ? uint16_t{128} : banks[channel], static_cast<uint8_t>(key & 0x7F)});
+                track.firstProgramTick[channel] = std::min(track.firstProgramTick[channel], absTicks);
+            }
+            if (options.collectNotes && (type == 0xB0 || type == 0xC0 || type == 0xE0)) {
+                track.channelEvents.push_back({absTicks, status, static_cast<uint8_t>(key & 0x7F),
+                                               static_cast<uint8_t>(velocity & 0x7F)});
+            }
+            if (type != NOTE_ON && type != NOTE_OFF) continue;
+
+            uint64_t& openTick = noteOnTicks[channel * 128 + (key & 0x7F)];
+            if (type == NOTE_ON && velocity > 0) {
+                openTick = absTicks;
+                noteOnVelocities[channel * 128 + (key & 0x7F)] = velocity & 0x7F;
+                track.channelMask |= static_cast<uint16_t>(1u << channel);
+                if (track.firstNoteTick[channel] == NO_NOTE) {
+                    track.firstNoteTick[channel] = absTicks;
+                    track.firstNoteBank[channel] = channel == 9 ? uint16_t{128} : banks[channel];
+                }
+            } else if (openTick != NO_NOTE) {
+                if (channel != 9) { // Ignore drums
+                    ++track.noteCount;
+                    if (options.collectNotes) {
+                        track.notes.push_back({openTick, absTicks, static_cast<uint8_t>(key & 0x7F), channel,
+                                               noteOnVelocities[channel * 128 + (key & 0x7F)]});
+                    }
+                }
+                openTick = NO_NOTE;
+            }
+        }
+        if (options.maxTick != UINT64_MAX && options.collectNotes) {
+            for (size_t slot = 0; slot < noteOnTicks.size(); ++slot) {
+                uint8_t channel = static_cast<uint8_t>(slot / 128);
+                if (noteOnTicks[slot] == NO_NOTE || channel == 9) continue;
+                track.notes.push_back({noteOnTicks[slot], absTicks, static_cast<uint8_t>(slot % 128), channel,
+                                       noteOnVelocities[slot]});
+            }
+        }
+        track.endTick = absTicks;
+
+        // Notes are found at their note-off; order them by start for the merge
+        std::stable_sort(track.notes.begin(), track.notes.end(), [](const TickNote& a, const TickNote& b) {
+            return a.startTick < b.startTick;
+        });
+    }
+
+    void ConvertTrackTimes(TrackData& track, const TempoMap& tempoMap) {
+        track.startTimes.resize(track.notes.size());
+        track.durations.resize(track.notes.size());
+        for (size_t i = 0; i < track.notes.size(); ++i) {
+            double start = tempoMap.TicksToSeconds(static_cast<double>(track.notes[i].startTick));
+            double finish = tempoMap.TicksToSeconds(static_cast<double>(track.notes[i].endTick));
+            track.startTimes[i] = static_cast<float>(start);
+            track.durations[i] = static_cast<float>(finish - start);
+        }
+    }
+
+    // k-way merge of the start-sorted tracks; equal starts keep track order
+    void MergeTracks(const std::vector<TrackData>& tracks, NoteStore& notes) {
+        size_t total = 0;
+        for (const auto& track : tracks) total += track.notes.size();
+        notes.Reserve(total);
+
+        using Head = std::pair<uint64_t, size_t>; // start tick, track
+        std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+        std::vector<size_t> positions(tracks.size(), 0);
+        for (size_t t = 0; t < tracks.size(); ++t) {
+            if (!tracks[t].notes.empty()) heads.push({tracks[t].notes[0].startTick, t});
+        }
+        while (!heads.empty()) {
+            size_t t = heads.top().second;
+            heads.pop();
+            const TrackData& track = tracks[t];
+            // Take the whole run that starts before the next track's head
+            uint64_t limit = heads.empty() ? UINT64_MAX : heads.top().first;
+            size_t tieTrack = heads.empty() ? SIZE_MAX : heads.top().second;
+            size_t& i = positions[t];
+            do {
+                const TickNote& note = track.notes[i];
+                notes.Add(track.startTimes[i], track.durations[i], note.key, note.channel);
+                ++i;
+            } while (i < track.notes.size() &&
+                     (track.notes[i].startTick < limit || (track.notes[i].startTick == limit && t < tieTrack)));
+            if (i < track.notes.size()) heads.push({track.notes[i].startTick, t});
+        }
+    }
+
+    void BuildSeekIndex(std::vector<TrackData>& tracks, const TempoMap& tempoMap, uint64_t totalTicks,
+                        SeekIndex& seekIndex) {
+        // Channel messages of all tracks in tick order; equal ticks keep track order
+        std::vector<SeekIndex::ChannelEvent> events;
+        for (auto& track : tracks) {
+            events.insert(events.end(), track.channelEvents.begin(), track.channelEvents.end());
+            std::vector<SeekIndex::ChannelEvent>().swap(track.channelEvents);
+        }
+        std::stable_sort(events.begin(), events.end(), [](const auto& a, const auto& b) { return a.tick < b.tick; });
+
+        seekIndex.Reset(tempoMap, totalTicks);
+        seekIndex.ApplyChannelEvents(events);
+        for (const auto& track : tracks) {
+            for (const TickNote& note : track.notes) {
+                seekIndex.AddNote(note.startTick, note.endTick, note.channel, note.key, note.velocity);
+            }
+        }
+        seekIndex.Finish();
+    }
+}
+
+MidiFileData ParseMidiFile(const uint8_t* data, size_t size, const MidiParseOptions& options) {
+    MidiFileData result;
+    result.tempoMap.Clear();
+    if (data == nullptr || size < 14 || std::memcmp(data, "MThd", 4) != 0) return result;
+
+    uint32_t headerLength = ReadBigEndian(data + 4, 4);
+    if (headerLength < 6 || headerLength > size - 8) return result;
+    result.format = static_cast<int>(ReadBigEndian(data + 8, 2));
+    result.trackCount = static_cast<int>(ReadBigEndian(data + 10, 2));
+    uint16_t division = static_cast<uint16_t>(ReadBigEndian(data + 12, 2));
+    result.ticksPerQuarter = (division & 0x8000) ? 480 : division;
+
+    // Find the track boundaries first, so the tracks can be decoded in parallel
+    std::vector<TrackData> tracks;
+    const uint8_t* end = data + size;
+    const uint8_t* chunk = data + 8 + headerLength;
+    while (static_cast<int>(tracks.size()) < result.trackCount && end - chunk >= 8) {
+        uint32_t chunkLength = ReadBigEndian(chunk + 4, 4);
+        const uint8_t* chunkData = chunk + 8;
+        const uint8_t* chunkEnd = chunkLength > static_cast<size_t>(end - chunkData) ? end : chunkData + chunkLength;
+        bool isTrack = std::memcmp(chunk, "MTrk", 4) == 0;
+        chunk = chunkEnd;
+        if (!isTrack) continue; // Unknown chunk types are skipped, as the spec requires
+        tracks.emplace_back().begin = chunkData;
+        tracks.back().end = chunkEnd;
+    }
+
+    bool parallel = options.parallel && tracks.size() > 1 && size >= PARALLEL_MIN_BYTES;
+    auto forEachTrack = [&](const std::function<void(TrackData&)>& fn) {
+        if (parallel) {
+            ThreadPool::Shared().ParallelFor(tracks.size(), [&](size_t i) { fn(tracks[i]); });
+        } else {
+            for (auto& track : tracks) fn(track);
+        }
+    };
+    forEachTrack([&](TrackData& track) { DecodeTrack(track, options); });
+
+    std::vector<TempoMap::TempoChange> tempoChanges;
+    std::array<uint64_t, 16> firstProgramTick;
+    std::array<uint64_t, 16> firstNoteTick;
+    std::array<uint16_t, 16> firstNoteBank{};
+    firstProgramTick.fill(NO_NOTE);
+    firstNoteTick.fill(NO_NOTE);
+    for (const auto& track : tracks) {
+        // Track order is kept, so the last of several tempo events on one tick still wins
+        tempoChanges.insert(tempoChanges.end(), track.tempoChanges.begin(), track.tempoChanges.end());
+        result.programs.insert(result.programs.end(), track.programs.begin(), track.programs.end());
+        for (int channel = 0; channel < 16; ++channel) {
+            firstProgramTick[channel] = std::min(firstProgramTick[channel], track.firstProgramTick[channel]);
+            if (track.firstNoteTick[channel] < firstNoteTick[channel]) {
+                firstNoteTick[channel] = track.firstNoteTick[channel];
+                firstNoteBank[channel] = track.firstNoteBank[channel];
+            }
+        }
+        result.stats.channelMask |= track.channelMask;
+        result.stats.noteCount += track.noteCount;
+        result.stats.totalTicks = std::max(result.stats.totalTicks, track.endTick);
+    }
+    // A channel that plays before any program change uses program 0 of its bank
+    for (int channel = 0; channel < 16; ++channel) {
+        if (firstNoteTick[channel] != NO_NOTE && firstNoteTick[channel] < firstProgramTick[channel]) {
+            result.programs.push_back({firstNoteBank[channel], 0});
+        }
+    }
+
+    if (division & 0x8000) {
+        // SMPTE division: frames per second (negative) and ticks per frame
+        int framesPerSecond = -static_cast<int8_t>(division >> 8);
+        result.tempoMap.BuildFixed(framesPerSecond * (division & 0xFF));
+    } else {
+        result.tempoMap.Build(result.ticksPerQuarter, std::move(tempoChanges));
+    }
+
+    std::sort(result.programs.begin(), result.programs.end());
+    result.programs.erase(std::unique(result.programs.begin(), result.programs.end()), result.programs.end());
+
+    if (options.collectNotes) {
+        forEachTrack([&](TrackData& track) { ConvertTrackTimes(track, result.tempoMap); });
+        MergeTracks(tracks, result.notes);
+        BuildSeekIndex(tracks, result.tempoMap, result.stats.totalTicks, result.seekIndex);
+    }
+    result.stats.durationSeconds = result.tempoMap.TicksToSeconds(static_cast<double>(result.stats.totalTicks));
+    result.stats.initialBpm = result.tempoMap.GetInitialBpm();
+    result.valid = true;
+    return result;
+}
@@ -0,0 +1,55 @@
+// MidiParser.h
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "NoteStore.h"
+#include "SeekIndex.h"
+#include "TempoMap.h"
+
+struct MidiSongStats {
+    size_t noteCount = 0;       // Playable (non-drum) notes
+    uint16_t channelMask = 0;   // Bit per channel that plays at least one note
+    uint64_t totalTicks = 0;
+    double durationSeconds = 0.0;
+    double initialBpm = 120.0;
+};
+
+// Instrument selected by a song, as the synth sees it: drums are bank 128
+struct MidiProgram {
+    uint16_t bank;
+    uint8_t program;
+
+    bool operator==(const MidiProgram&) const = default;
+    auto operator<=>(const MidiProgram&) const = default;
+};
+
+struct MidiFileData {
+    bool valid = false;
+    int format = 0;
+    int trackCount = 0;
+    int ticksPerQuarter = 480;
+    TempoMap tempoMap;
+    NoteStore notes; // Sorted by start time; equal starts keep file order
+    std::vector<MidiProgram> programs; // Sorted and distinct, including the default of channels that never change it
+    SeekIndex seekIndex; // Only built when notes are collected
+    MidiSongStats stats;
+};
+
+struct MidiParseOptions {
+    // False produces only the header, tempo map and stats
+    bool collectNotes = true;
+    // Tracks stop at this tick; notes still held there are cut off at it. Used
+    // for a quick preview of the start of a song.
+    uint64_t maxTick = UINT64_MAX;
+    // Decode the tracks of large files on the shared thread pool
+    bool parallel = true;
+};
+
+// Parses a Standard MIDI File straight from memory. Track chunks are located
+// first, then decoded independently (in parallel for large files) and merged
+// by start time. Every read is bounds-checked: a truncated or malformed track
+// ends at its last complete event.
+MidiFileData ParseMidiFile(const uint8_t* data, size_t size, const MidiParseOptions& options = {});
@@ -0,0 +1,26 @@
+// MidiSong.cpp
+#include "MidiSong.h"
+
+std::shared_ptr<MidiSong> LoadMidiSong(const uint8_t* data, size_t size, const MidiParseOptions& options) {
+    auto song = std::make_shared<MidiSong>();
+    song->file = ParseMidiFile(data, size, options);
+    song->noteIndex.Build(song->file.notes);
+    song->lod.Build(song->file.notes);
+    song->complete = options.maxTick == UINT64_MAX;
+    return song;
+}
+
+NoteView SelectNotes(const MidiSong& song, double fromTime, double toTime, float fallSpeed) {
+    NoteIndex::Range raw = song.noteIndex.Query(fromTime, toTime);
+    int level = song.lod.Select(raw.Size(), fallSpeed);
+    if (level < 0) return {&song.file.notes, &song.noteIndex, raw, -1};
+    const std::vector<NoteLod::Level>& levels = song.lod.GetLevels();
+    NoteIndex::Range range = levels[level].index.Query(fromTime, toTime);
+    // Runs are merged per channel, so many channels on the same keys can still
+    // leave too many; coarser levels keep the frame bounded
+    while (song.lod.OverBudget(range.Size()) && level + 1 < static_cast<int>(levels.size())) {
+        ++level;
+        range = levels[level].index.Query(fromTime, toTime);
+    }
+    return {&levels[level].runs, &levels[level].index, range, level};
+}
@@ -0,0 +1,32 @@
+// MidiSong.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "MidiParser.h"
+#include "NoteIndex.h"
+#include "NoteLod.h"
+
+// A parsed song ready to draw: notes sorted by start time, their index and
+// the merged levels for dense passages.
+// Published songs are shared read-only between the loader and the UI.
+struct MidiSong {
+    MidiFileData file;
+    NoteIndex noteIndex;
+    NoteLod lod;
+    bool complete = true; // False for a preview that only covers the start of the song
+};
+
+// The blocks to draw for a time window: the raw notes, or a LOD level when the
+// window is too dense to draw note by note
+struct NoteView {
+    const NoteStore* notes;
+    const NoteIndex* index; // Resolves the long blocks of range
+    NoteIndex::Range range;
+    int level; // -1 for the raw notes
+};
+
+NoteView SelectNotes(const MidiSong& song, double fromTime, double toTime, float fallSpeed);
+
+std::shared_ptr<MidiSong> LoadMidiSong(const uint8_t* data, size_t size, const MidiParseOptions& options = {});
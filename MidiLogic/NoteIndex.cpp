@@ -0,0 +1,73 @@
+// NoteIndex.cpp
+#include "NoteIndex.h"
+
+#include <algorithm>
+
+NoteIndex midiNoteIndex;
+
+void NoteIndex::Build(NoteStore& notes) {
+    notes.SortByStart();
+    blockCount = notes.Size();
+
+    double songEnd = 0.0;
+    for (size_t i = 0; i < blockCount; ++i) {
+        songEnd = std::max(songEnd, static_cast<double>(notes.EndTime(i)));
+    }
+    // Very long (or corrupt) files get wider buckets instead of a huge table
+    bucketSeconds = std::max(MIN_BUCKET_SECONDS, songEnd / MAX_BUCKETS);
+    size_t bucketCount = static_cast<size_t>(songEnd / bucketSeconds) + 2;
+
+    // Both tables have a trailing sentinel so Query can read bucket + 1
+    bucketStart.assign(bucketCount + 1, blockCount);
+    bucketFirstAlive.assign(bucketCount + 1, blockCount);
+    longNotes.clear();
+    float longSeconds = static_cast<float>(bucketSeconds * LONG_NOTE_BUCKETS);
+    for (size_t i = blockCount; i-- > 0;) {
+        bucketStart[BucketFor(notes.StartTime(i))] = i;
+    }
+    for (size_t i = 0; i < blockCount; ++i) {
+        if (notes.Duration(i) > longSeconds) {
+            longNotes.push_back(i);
+            continue;
+        }
+        size_t endBucket = BucketFor(notes.EndTime(i));
+        bucketFirstAlive[endBucket] = std::min(bucketFirstAlive[endBucket], i);
+    }
+    bucketFirstLong.assign(bucketCount + 1, longNotes.size());
+    for (size_t pos = 0; pos < longNotes.size(); ++pos) {
+        size_t endBucket = BucketFor(notes.EndTime(longNotes[pos]));
+        bucketFirstLong[endBucket] = std::min(bucketFirstLong[endBucket], pos);
+    }
+    // Empty buckets inherit from the next one; a block still sounding in a later
+    // bucket is also sounding in every bucket between its start and its end
+    for (size_t b = bucketCount; b-- > 0;) {
+        bucketStart[b] = std::min(bucketStart[b], bucketStart[b + 1]);
+        bucketFirstAlive[b] = std::min(bucketFirstAlive[b], bucketFirstAlive[b + 1]);
+        bucketFirstLong[b] = std::min(bucketFirstLong[b], bucketFirstLong[b + 1]);
+    }
+}
+
+void NoteIndex::Clear() {
+    blockCount = 0;
+    bucketStart.clear();
+    bucketFirstAlive.clear();
+    longNotes.clear();
+    bucketFirstLong.clear();
+}
+
+NoteIndex::Range NoteIndex::Query(double fromTime, double toTime) const {
+    if (blockCount == 0 || toTime < fromTime) return {0, 0};
+    size_t bucket = BucketFor(fromTime);
+    size_t first = bucketFirstAlive[bucket];
+    size_t last = bucketStart[BucketFor(toTime) + 1];
+    // Long blocks from first on are already in the main range
+    size_t longLast = std::lower_bound(longNotes.begin(), longNotes.end(), first) - longNotes.begin();
+    size_t longFirst = std::min(bucketFirstLong[bucket], longLast);
+    return {first, std::max(first, last), longFirst, longLast};
+}
+
+size_t NoteIndex::BucketFor(double time) const {
+    if (time <= 0.0) return 0;
+    double lastBucket = static_cast<double>(bucketStart.size() - 2);
+    return static_cast<size_t>(std::min(time / bucketSeconds, lastBucket));
+}
@@ -0,0 +1,55 @@
+// NoteIndex.h
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "NoteStore.h"
+
+// Bucketed start-time index over a start-sorted block list, so a frame only
+// visits the blocks that can overlap the visible time window. Blocks lasting
+// several buckets are also listed apart, so one held note does not drag the
+// start of every later window back to it.
+class NoteIndex {
+public:
+    struct Range {
+        size_t first; // first candidate block (inclusive)
+        size_t last;  // one past the last candidate block
+        // Long blocks that started before first and may still be sounding, as
+        // positions for LongNote
+        size_t longFirst = 0;
+        size_t longLast = 0;
+
+        size_t Size() const { return (last - first) + (longLast - longFirst); }
+    };
+
+    // Sorts notes by start time and rebuilds the bucket tables
+    void Build(NoteStore& notes);
+
+    void Clear();
+
+    // Returns the blocks that may overlap [fromTime, toTime]: [first, last) and
+    // the long blocks [longFirst, longLast). Blocks in either can still have
+    // ended before fromTime; callers skip those.
+    Range Query(double fromTime, double toTime) const;
+
+    // Block index of the long block at a position from Range::longFirst/longLast
+    size_t LongNote(size_t position) const { return longNotes[position]; }
+    const std::vector<size_t>& GetLongNotes() const { return longNotes; }
+
+private:
+    static constexpr double MIN_BUCKET_SECONDS = 0.5;
+    static constexpr size_t MAX_BUCKETS = 1 << 16;
+    // Blocks lasting longer than this many buckets go to the long list
+    static constexpr double LONG_NOTE_BUCKETS = 8.0;
+
+    double bucketSeconds = MIN_BUCKET_SECONDS;
+    size_t blockCount = 0;
+    std::vector<size_t> bucketStart;      // first block with startTime >= bucket start
+    std::vector<size_t> bucketFirstAlive; // first short block still sounding at bucket start
+    std::vector<size_t> longNotes;        // long blocks, in block order
+    std::vector<size_t> bucketFirstLong;  // first longNotes position still sounding at bucket start
+
+    size_t BucketFor(double time) const;
+};
+
+extern NoteIndex midiNoteIndex;
@@ -0,0 +1,82 @@
+// NoteLod.cpp
+#include "NoteLod.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    constexpr int MIDI_KEYS = 128;
+    constexpr int MIDI_CHANNELS = 16;
+
+    struct Run {
+        double start;
+        double end;
+        bool open = false;
+    };
+
+    // Merges the start-sorted blocks of every key and channel into runs on a
+    // grid of quantum seconds. Channels are merged apart so each run keeps the
+    // color of all of its notes.
+    NoteStore MergeRuns(const NoteStore& notes, double quantum) {
+        NoteStore runs;
+        std::array<Run, MIDI_CHANNELS * MIDI_KEYS> open{};
+        auto close = [&](int slot) {
+            Run& run = open[slot];
+            if (!run.open) return;
+            runs.Add(static_cast<float>(run.start), static_cast<float>(run.end - run.start),
+                     static_cast<uint8_t>(slot % MIDI_KEYS), static_cast<uint8_t>(slot / MIDI_KEYS));
+            run.open = false;
+        };
+
+        for (size_t i = 0; i < notes.Size(); ++i) {
+            int slot = (notes.Channel(i) & (MIDI_CHANNELS - 1)) * MIDI_KEYS + (notes.Key(i) & (MIDI_KEYS - 1));
+            double start = std::floor(notes.StartTime(i) / quantum) * quantum;
+            double end = std::max(std::ceil(notes.EndTime(i) / quantum) * quantum, start + quantum);
+            Run& run = open[slot];
+            if (run.open && start <= run.end) {
+                run.end = std::max(run.end, end);
+                continue;
+            }
+            close(slot);
+            run = {start, end, true};
+        }
+        for (int slot = 0; slot < MIDI_CHANNELS * MIDI_KEYS; ++slot) close(slot);
+        return runs;
+    }
+}
+
+void NoteLod::Build(const NoteStore& notes) {
+    levels.clear();
+    if (notes.Size() <= RAW_BUDGET) return;
+
+    // Each level is merged from the last kept one; runs on a finer grid are
+    // still aligned to every coarser grid, so this matches merging the raw notes
+    levels.reserve(QUANTUM_STEPS); // finer points into levels
+    const NoteStore* finer = &notes;
+    double quantum = FIRST_QUANTUM;
+    for (int step = 0; step < QUANTUM_STEPS; ++step, quantum *= 2.0) {
+        NoteStore runs = MergeRuns(*finer, quantum);
+        if (runs.Size() > finer->Size() * MIN_REDUCTION) continue;
+        Level& level = levels.emplace_back();
+        level.quantum = quantum;
+        level.runs = std::move(runs);
+        level.index.Build(level.runs);
+        finer = &level.runs;
+    }
+}
+
+int NoteLod::Select(size_t rawVisible, float fallSpeed) const {
+    if (rawVisible <= RAW_BUDGET || levels.empty() || fallSpeed <= 0.0f) return -1;
+    double quantum = MIN_RUN_PIXELS / fallSpeed;
+    for (size_t i = 0; i < levels.size(); ++i) {
+        if (levels[i].quantum >= quantum) return static_cast<int>(i);
+    }
+    return static_cast<int>(levels.size()) - 1;
+}
+
+size_t NoteLod::MemoryBytes() const {
+    size_t bytes = 0;
+    for (const Level& level : levels) bytes += level.runs.MemoryBytes();
+    return bytes;
+}
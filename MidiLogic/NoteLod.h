@@ -0,0 +1,52 @@
+// NoteLod.h
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "NoteStore.h"
+#include "NoteIndex.h"
+
+// Coarser versions of a dense song for drawing. Each level merges the notes of
+// a key and channel into coverage runs: notes that overlap or touch once their
+// times are snapped to the level's time quantum become one block. Quanta double
+// from level to level, so a column never holds more runs per channel than its
+// visible time divided by the quantum.
+class NoteLod {
+public:
+    struct Level {
+        double quantum; // Seconds
+        NoteStore runs;
+        NoteIndex index;
+    };
+
+    // notes must be sorted by start time. Songs that never have more visible
+    // notes than the raw budget get no levels.
+    void Build(const NoteStore& notes);
+
+    void Clear() { levels.clear(); }
+
+    const std::vector<Level>& GetLevels() const { return levels; }
+
+    // Level to draw for a window with rawVisible candidate notes, or -1 for the
+    // raw notes. Sparse windows always draw the raw notes, so normal songs look
+    // exactly as before; dense ones use the finest level whose runs are at
+    // least MIN_RUN_PIXELS tall at this fall speed.
+    int Select(size_t rawVisible, float fallSpeed) const;
+
+    // True if a window with this many candidate blocks is worth drawing from a
+    // coarser level, when there is one
+    bool OverBudget(size_t visible) const { return visible > RAW_BUDGET; }
+
+    size_t MemoryBytes() const;
+
+private:
+    static constexpr size_t RAW_BUDGET = 16384;
+    static constexpr double MIN_RUN_PIXELS = 2.0;
+    static constexpr double FIRST_QUANTUM = 1.0 / 512.0;
+    static constexpr int QUANTUM_STEPS = 7; // Up to 1/4 s
+    // A level is only kept if it merges at least a quarter of the blocks of the
+    // finer level below it
+    static constexpr double MIN_REDUCTION = 0.75;
+
+    std::vector<Level> levels;
+};
@@ -0,0 +1,55 @@
+// NoteStore.cpp
+#include "NoteStore.h"
+
+#include <algorithm>
+#include <numeric>
+
+NoteStore midiNotes;
+
+namespace {
+    template<typename T>
+    void Permute(std::vector<T>& values, const std::vector<uint32_t>& order) {
+        std::vector<T> sorted(values.size());
+        for (size_t i = 0; i < order.size(); ++i) sorted[i] = values[order[i]];
+        values.swap(sorted);
+    }
+}
+
+void NoteStore::Reserve(size_t count) {
+    startTimes.reserve(count);
+    durations.reserve(count);
+    keys.reserve(count);
+    channels.reserve(count);
+}
+
+void NoteStore::Add(float startTime, float duration, uint8_t key, uint8_t channel) {
+    startTimes.push_back(startTime);
+    durations.push_back(duration);
+    keys.push_back(key);
+    channels.push_back(channel);
+}
+
+void NoteStore::Clear() {
+    startTimes.clear();
+    durations.clear();
+    keys.clear();
+    channels.clear();
+}
+
+void NoteStore::SortByStart() {
+    if (std::is_sorted(startTimes.begin(), startTimes.end())) return;
+    std::vector<uint32_t> order(startTimes.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+        return startTimes[a] < startTimes[b];
+    });
+    Permute(startTimes, order);
+    Permute(durations, order);
+    Permute(keys, order);
+    Permute(channels, order);
+}
+
+size_t NoteStore::MemoryBytes() const {
+    return startTimes.capacity() * sizeof(float) + durations.capacity() * sizeof(float) +
+           keys.capacity() + channels.capacity();
+}
@@ -0,0 +1,45 @@
+// NoteStore.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// The notes of a song as parallel arrays, 10 bytes per note. Times are float
+// seconds from the start of the song, already converted through the tempo
+// map; that keeps sub-millisecond precision for songs up to a few hours. The
+// channel doubles as the palette index for the block color, so no color is
+// stored. Scans that only test times touch nothing but the two float arrays.
+class NoteStore {
+public:
+    size_t Size() const { return startTimes.size(); }
+    bool Empty() const { return startTimes.empty(); }
+
+    void Reserve(size_t count);
+    void Add(float startTime, float duration, uint8_t key, uint8_t channel);
+    void Clear();
+
+    // Stable sort by start time, applied to every array
+    void SortByStart();
+
+    float StartTime(size_t i) const { return startTimes[i]; }
+    float Duration(size_t i) const { return durations[i]; }
+    float EndTime(size_t i) const { return startTimes[i] + durations[i]; }
+    uint8_t Key(size_t i) const { return keys[i]; }
+    uint8_t Channel(size_t i) const { return channels[i]; }
+
+    const float* StartTimes() const { return startTimes.data(); }
+    const float* Durations() const { return durations.data(); }
+    const uint8_t* Keys() const { return keys.data(); }
+    const uint8_t* Channels() const { return channels.data(); }
+
+    size_t MemoryBytes() const;
+
+private:
+    std::vector<float> startTimes;
+    std::vector<float> durations;
+    std::vector<uint8_t> keys;
+    std::vector<uint8_t> channels;
+};
+
+extern NoteStore midiNotes;
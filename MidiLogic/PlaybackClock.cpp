@@ -0,0 +1,171 @@
+// PlaybackClock.cpp
+#include "PlaybackClock.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+PlaybackClock::PlaybackClock(fluid_settings_t* settings, fluid_synth_t* synth) : synth(synth) {
+    fluid_settings_getnum(settings, "synth.sample-rate", &sampleRate);
+    driver = new_fluid_audio_driver2(settings, Render, this);
+    sampleAccurate = driver != nullptr;
+    if (driver == nullptr) {
+        std::cerr << "Audio driver does not take a render callback; the playback clock follows frames" << std::endl;
+        driver = new_fluid_audio_driver(settings, synth);
+    }
+}
+
+PlaybackClock::~PlaybackClock() {
+    Close();
+}
+
+void PlaybackClock::Close() {
+    if (driver == nullptr) return;
+    delete_fluid_audio_driver(driver);
+    driver = nullptr;
+}
+
+double PlaybackClock::Seconds(Clock::time_point time) {
+    return std::chrono::duration<double>(time.time_since_epoch()).count();
+}
+
+int PlaybackClock::Render(void* data, int len, int nfx, float* fx[], int nout, float* out[]) {
+    auto* clock = static_cast<PlaybackClock*>(data);
+    Clock::time_point start = Clock::now();
+    clock->sequence.fetch_add(1, std::memory_order_acq_rel);
+    int result = fluid_synth_process(clock->synth, len, nfx, fx, nout, out);
+    Clock::time_point end = Clock::now();
+    clock->samplesRendered.fetch_add(static_cast<uint64_t>(len), std::memory_order_relaxed);
+    clock->renderedAt.store(end.time_since_epoch().count(), std::memory_order_relaxed);
+    clock->sequence.fetch_add(1, std::memory_order_release);
+
+    double bufferSeconds = len / clock->sampleRate;
+    bool slow = std::chrono::duration<double>(end - start).count() > bufferSeconds;
+    bool starved = clock->lastCallback != Clock::time_point{} &&
+                   std::chrono::duration<double>(start - clock->lastCallback).count() > 2.0 * bufferSeconds + 0.005;
+    if (slow || starved) clock->lateBuffers.fetch_add(1, std::memory_order_relaxed);
+    clock->lastCallback = start;
+
+    if (RenderListener listener = clock->renderListener.load(std::memory_order_acquire)) {
+        listener(clock->renderListenerData.load(std::memory_order_relaxed), start, end, bufferSeconds);
+    }
+    return result;
+}
+
+void PlaybackClock::SetRenderListener(RenderListener listener, void* data) {
+    // The data is in place before the audio thread can see the listener
+    renderListener.store(nullptr, std::memory_order_release);
+    renderListenerData.store(data, std::memory_order_relaxed);
+    renderListener.store(listener, std::memory_order_release);
+}
+
+bool PlaybackClock::ReadAnchor(fluid_player_t* player, Anchor& next) const {
+    if (!sampleAccurate) {
+        next.tick = fluid_player_get_current_tick(player);
+        next.realSeconds = Seconds(Clock::now());
+        return true;
+    }
+    // The tick, sample count and time must all come from the same callback;
+    // if one is rendering right now, the previous anchor is kept for this frame
+    uint32_t before = sequence.load(std::memory_order_acquire);
+    if (before & 1u) return false;
+    next.tick = fluid_player_get_current_tick(player);
+    next.samples = samplesRendered.load(std::memory_order_relaxed);
+    next.realSeconds = Seconds(Clock::time_point(Clock::duration(renderedAt.load(std::memory_order_relaxed))));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return sequence.load(std::memory_order_relaxed) == before;
+}
+
+double PlaybackClock::Update(fluid_player_t* player, const TempoMap& tempoMap, bool playing) {
+    double now = Seconds(Clock::now());
+    double elapsed = hasAnchor ? now - lastUpdate : 0.0;
+    lastUpdate = now;
+
+    if (seekPending) {
+        if (!SeekApplied(player, playing)) {
+            wasPlaying = playing;
+            return displayed;
+        }
+        // The new position is anchored from scratch
+        seekPending = false;
+        hasAnchor = false;
+        wasPlaying = false;
+    }
+
+    Anchor next;
+    if (ReadAnchor(player, next)) {
+        next.songSeconds = tempoMap.TicksToSeconds(next.tick);
+        bool moved = sampleAccurate ? next.samples != anchor.samples : next.tick != anchor.tick;
+        if (!hasAnchor || next.tick < anchor.tick) {
+            // First anchor, or the player went back (seek or new song)
+            anchor = next;
+            hasAnchor = true;
+            displayed = next.songSeconds;
+        } else if (moved) {
+            double realDelta = sampleAccurate ? (next.samples - anchor.samples) / sampleRate
+                                              : next.realSeconds - anchor.realSeconds;
+            // Rates measured across a pause or a resume would be meaningless
+            if (playing && wasPlaying && realDelta > 0.0) {
+                rate = std::clamp((next.songSeconds - anchor.songSeconds) / realDelta, 0.0, 8.0);
+            }
+            anchor = next;
+        } else {
+            // Same tick as before but a fresh song time, e.g. the tempo map was just published
+            anchor.songSeconds = next.songSeconds;
+        }
+    }
+    if (!hasAnchor) return tempoMap.TicksToSeconds(fluid_player_get_current_tick(player));
+
+    if (!playing) {
+        displayed = anchor.songSeconds;
+    } else {
+        double ahead = std::clamp(now - anchor.realSeconds, 0.0, MAX_EXTRAPOLATION);
+        double predicted = anchor.songSeconds + ahead * rate;
+        double advanced = displayed + elapsed * rate;
+        double error = predicted - advanced;
+        if (!wasPlaying || std::abs(error) > SNAP_SECONDS) {
+            displayed = predicted;
+        } else {
+            // Ease towards the prediction without ever moving backwards
+            displayed = std::max(displayed, advanced + error * std::min(1.0, elapsed / CORRECTION_SECONDS));
+        }
+    }
+    wasPlaying = playing;
+    return displayed;
+}
+
+void PlaybackClock::Reset() {
+    hasAnchor = false;
+    anchor = Anchor{};
+    displayed = 0.0;
+    wasPlaying = false;
+    seekPending = false;
+}
+
+void PlaybackClock::Seek(double songSeconds) {
+    Reset();
+    displayed = songSeconds;
+    seekPending = true;
+    seekArmed = false;
+}
+
+bool PlaybackClock::SeekApplied(fluid_player_t* player, bool playing) {
+    // A paused player keeps the seek for when it plays again
+    if (!playing) {
+        seekArmed = false;
+        return false;
+    }
+    if (!seekArmed) {
+        // Wait for a whole buffer that starts after now; one rendering at the
+        // moment may have run the player before the seek was set
+        uint32_t current = sequence.load(std::memory_order_acquire);
+        seekSequence = current + ((current & 1u) ? 3u : 2u);
+        tickBeforeSeek = fluid_player_get_current_tick(player);
+        seekArmed = true;
+        return false;
+    }
+    if (sampleAccurate) {
+        return static_cast<int32_t>(sequence.load(std::memory_order_acquire) - seekSequence) >= 0;
+    }
+    return fluid_player_get_current_tick(player) != tickBeforeSeek;
+}
@@ -0,0 +1,100 @@
+// PlaybackClock.h
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fluidsynth.h>
+#include "TempoMap.h"
+
+// Song position for drawing, smooth at any refresh rate. The player's tick
+// only moves when the audio driver renders a buffer, so on its own it steps
+// every few milliseconds. This clock owns the audio driver and counts the
+// samples each callback renders. Every tick it reads is paired with the time
+// its buffer finished rendering, and the clock extrapolates from that anchor
+// with the steady clock. Drift against newer anchors is corrected gradually;
+// jumps (seeks, song changes) snap. If the driver can't take a callback, it
+// anchors on the frame where the tick changed instead.
+class PlaybackClock {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    PlaybackClock(fluid_settings_t* settings, fluid_synth_t* synth);
+    PlaybackClock(const PlaybackClock&) = delete;
+    PlaybackClock& operator=(const PlaybackClock&) = delete;
+    ~PlaybackClock();
+
+    // Deletes the audio driver; must run before the synth is deleted
+    void Close();
+
+    bool IsSampleAccurate() const { return sampleAccurate; }
+
+    // Buffers that took longer to render than they last, or whose callback
+    // came so late that the device must have run dry; zero without the callback
+    uint32_t GetLateBuffers() const { return lateBuffers.load(std::memory_order_relaxed); }
+
+    // Song seconds that have been rendered as of now; call once per frame.
+    // While paused it is exactly the player's position.
+    double Update(fluid_player_t* player, const TempoMap& tempoMap, bool playing);
+
+    // Forgets the anchors, after a song change
+    void Reset();
+
+    // The player was just told to seek to songSeconds. It only applies that in
+    // the next buffer it renders while playing; until then Update reports the
+    // target instead of the stale tick.
+    void Seek(double songSeconds);
+
+    // True from Seek until a buffer that started after it has finished playing
+    bool IsSeekPending() const { return seekPending; }
+
+    // Called on the audio thread after every buffer, with when it started and
+    // finished rendering and how much audio it holds. Never called without the
+    // render callback. Pass nullptr to detach.
+    using RenderListener = void (*)(void* data, Clock::time_point started, Clock::time_point finished,
+                                    double bufferSeconds);
+    void SetRenderListener(RenderListener listener, void* data);
+
+private:
+    static constexpr double SNAP_SECONDS = 0.1;        // Larger errors jump instead of easing
+    static constexpr double CORRECTION_SECONDS = 0.15; // Time to work off a small error
+    static constexpr double MAX_EXTRAPOLATION = 0.1;   // Longest time to run ahead of an anchor
+
+    fluid_audio_driver_t* driver = nullptr;
+    fluid_synth_t* synth;
+    double sampleRate = 44100.0;
+    bool sampleAccurate = false;
+
+    // Written by the audio thread; sequence is odd while a buffer is rendering
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> samplesRendered{0};
+    std::atomic<int64_t> renderedAt{0}; // Clock ticks since its epoch
+    std::atomic<uint32_t> lateBuffers{0};
+    Clock::time_point lastCallback{}; // Audio thread only
+    std::atomic<RenderListener> renderListener{nullptr};
+    std::atomic<void*> renderListenerData{nullptr};
+
+    // Render thread state
+    struct Anchor {
+        int tick = -1;
+        uint64_t samples = 0;
+        double songSeconds = 0.0;
+        double realSeconds = 0.0;
+    };
+    Anchor anchor;
+    bool hasAnchor = false;
+    double rate = 1.0; // Song seconds per real second
+    double displayed = 0.0;
+    double lastUpdate = 0.0;
+    bool wasPlaying = false;
+
+    bool seekPending = false;
+    bool seekArmed = false;     // Waiting on seekSequence or tickBeforeSeek
+    uint32_t seekSequence = 0;  // First sequence value after a buffer rendered since arming
+    int tickBeforeSeek = -1;    // Fallback without the callback: any tick change
+
+    static int Render(void* data, int len, int nfx, float* fx[], int nout, float* out[]);
+    static double Seconds(Clock::time_point time);
+    bool ReadAnchor(fluid_player_t* player, Anchor& next) const;
+    bool SeekApplied(fluid_player_t* player, bool playing);
+};
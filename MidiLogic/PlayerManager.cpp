@@ -0,0 +1,56 @@
+// PlayerManager.cpp
+#include "PlayerManager.h"
+
+PlayerManager::PlayerManager(fluid_synth_t* synth, handle_midi_event_func_t callback, void* callbackData)
+    : synth(synth), callback(callback), callbackData(callbackData) {}
+
+PlayerManager::~PlayerManager() {
+    Clear();
+}
+
+fluid_player_t* PlayerManager::Activate(const std::string& midiPath, const MappedFile* midiFile) {
+    DeletePlayer(active);
+    // A stopped player sends no note-offs; silence whatever it left sounding
+    fluid_synth_all_notes_off(synth, -1);
+
+    if (standby != nullptr && standbyPath == midiPath) {
+        active = standby;
+        standby = nullptr;
+        standbyPath.clear();
+    } else {
+        active = CreatePlayer(midiFile);
+    }
+    return active;
+}
+
+void PlayerManager::PrepareStandby(const std::string& midiPath, const MappedFile* midiFile) {
+    if (standby != nullptr && standbyPath == midiPath) return;
+    DeletePlayer(standby);
+    standby = CreatePlayer(midiFile);
+    standbyPath = midiPath;
+}
+
+void PlayerManager::Clear() {
+    DeletePlayer(standby);
+    DeletePlayer(active);
+    standbyPath.clear();
+}
+
+fluid_player_t* PlayerManager::CreatePlayer(const MappedFile* midiFile) {
+    fluid_player_t* player = new_fluid_player(synth);
+    if (player == nullptr) return nullptr;
+    // A file that could not be read leaves the player with nothing to play.
+    // fluid_player_add_mem copies the bytes, so the caller may unmap them after.
+    if (midiFile != nullptr && midiFile->IsOpen()) {
+        fluid_player_add_mem(player, midiFile->Data(), midiFile->Size());
+    }
+    fluid_player_set_playback_callback(player, callback, callbackData);
+    return player;
+}
+
+void PlayerManager::DeletePlayer(fluid_player_t*& player) {
+    if (player == nullptr) return;
+    fluid_player_stop(player);
+    delete_fluid_player(player);
+    player = nullptr;
+}
@@ -0,0 +1,47 @@
+// PlayerManager.h
+#pragma once
+
+#include <string>
+#include <fluidsynth.h>
+#include "../utils/MappedFile.h"
+
+// Owns the FluidSynth players. Besides the active player it keeps one standby
+// player with the next song's bytes already added from memory and the playback
+// callback installed, so a song switch is a swap and a play call rather than a
+// new player and a file read, and every replaced player is deleted instead of
+// leaking.
+class PlayerManager {
+public:
+    PlayerManager(fluid_synth_t* synth, handle_midi_event_func_t callback, void* callbackData);
+    PlayerManager(const PlayerManager&) = delete;
+    PlayerManager& operator=(const PlayerManager&) = delete;
+    ~PlayerManager();
+
+    // Makes midiPath the active song and returns its player. The previous
+    // player is stopped and deleted; the standby is used if it holds midiPath.
+    // Otherwise the new player gets the bytes of midiFile, so the file is not
+    // read a second time by FluidSynth. FluidSynth copies the bytes, so the
+    // mapping only has to outlive the call.
+    fluid_player_t* Activate(const std::string& midiPath, const MappedFile* midiFile);
+
+    // Loads the song most likely to be played next into the standby player,
+    // from the loader's mapping of it
+    void PrepareStandby(const std::string& midiPath, const MappedFile* midiFile);
+
+    fluid_player_t* GetActive() const { return active; }
+
+    // Deletes both players; must run before the synth is deleted
+    void Clear();
+
+private:
+    fluid_synth_t* synth;
+    handle_midi_event_func_t callback;
+    void* callbackData;
+
+    fluid_player_t* active = nullptr;
+    fluid_player_t* standby = nullptr;
+    std::string standbyPath;
+
+    fluid_player_t* CreatePlayer(const MappedFile* midiFile);
+    void DeletePlayer(fluid_player_t*& player);
+};
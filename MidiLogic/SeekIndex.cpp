@@ -0,0 +1,98 @@
+// SeekIndex.cpp
+#include "SeekIndex.h"
+
+#include <algorithm>
+#include <cmath>
+
+void SeekIndex::Reset(const TempoMap& tempoMap, uint64_t totalTicks) {
+    checkpoints.clear();
+    heldNotes.clear();
+    pendingNotes.clear();
+    nextCheckpoint = 0;
+
+    // Long songs get sparser checkpoints instead of an unbounded table
+    double duration = tempoMap.TicksToSeconds(static_cast<double>(totalTicks));
+    double interval = std::max(MIN_INTERVAL_SECONDS, duration / MAX_CHECKPOINTS);
+    for (double seconds = 0.0; seconds <= duration; seconds += interval) {
+        uint64_t tick = static_cast<uint64_t>(std::floor(tempoMap.SecondsToTicks(seconds)));
+        if (!checkpoints.empty() && tick <= checkpoints.back().tick) continue;
+        Checkpoint& checkpoint = checkpoints.emplace_back();
+        checkpoint.tick = tick;
+        checkpoint.seconds = tempoMap.TicksToSeconds(static_cast<double>(tick));
+        for (int channel = 0; channel < 16; ++channel) {
+            // Drums are bank 128, as the synth sees them
+            checkpoint.channels[channel].bank = channel == 9 ? 128 : 0;
+        }
+    }
+    pendingNotes.resize(checkpoints.size());
+}
+
+void SeekIndex::ApplyChannelEvents(const std::vector<ChannelEvent>& events) {
+    std::array<ChannelState, 16> state = checkpoints.empty() ? std::array<ChannelState, 16>{} : checkpoints[0].channels;
+    size_t next = 0;
+    for (Checkpoint& checkpoint : checkpoints) {
+        // Messages on the checkpoint's own tick are included; sending them again is harmless
+        for (; next < events.size() && events[next].tick <= checkpoint.tick; ++next) {
+            const ChannelEvent& event = events[next];
+            ChannelState& channel = state[event.status & 0x0F];
+            switch (event.status & 0xF0) {
+                case 0xB0: {
+                    if (event.data1 == 0) {
+                        if ((event.status & 0x0F) != 9) channel.bank = event.data2;
+                        break;
+                    }
+                    auto it = std::find(CONTROLLERS.begin(), CONTROLLERS.end(), event.data1);
+                    if (it != CONTROLLERS.end()) channel.controllers[it - CONTROLLERS.begin()] = event.data2;
+                    break;
+                }
+                case 0xC0:
+                    channel.program = event.data1;
+                    break;
+                case 0xE0:
+                    channel.pitchBend = static_cast<uint16_t>((event.data2 << 7) | event.data1);
+                    break;
+            }
+        }
+        checkpoint.channels = state;
+    }
+}
+
+void SeekIndex::AddNote(uint64_t startTick, uint64_t endTick, uint8_t channel, uint8_t key, uint8_t velocity) {
+    // First checkpoint after the note starts; notes arrive mostly in start order
+    size_t k = nextCheckpoint;
+    if (k > checkpoints.size() || (k > 0 && checkpoints[k - 1].tick > startTick)) {
+        k = std::upper_bound(checkpoints.begin(), checkpoints.end(), startTick,
+                             [](uint64_t tick, const Checkpoint& checkpoint) { return tick < checkpoint.tick; }) -
+            checkpoints.begin();
+    }
+    while (k < checkpoints.size() && checkpoints[k].tick <= startTick) ++k;
+    nextCheckpoint = k;
+
+    for (; k < checkpoints.size() && checkpoints[k].tick < endTick; ++k) {
+        if (pendingNotes[k].size() < MAX_HELD_NOTES) pendingNotes[k].push_back({endTick, channel, key, velocity});
+    }
+}
+
+void SeekIndex::Finish() {
+    size_t total = 0;
+    for (const auto& notes : pendingNotes) total += notes.size();
+    heldNotes.reserve(total);
+    for (size_t k = 0; k < checkpoints.size(); ++k) {
+        checkpoints[k].firstHeldNote = static_cast<uint32_t>(heldNotes.size());
+        checkpoints[k].heldNoteCount = static_cast<uint32_t>(pendingNotes[k].size());
+        heldNotes.insert(heldNotes.end(), pendingNotes[k].begin(), pendingNotes[k].end());
+    }
+    pendingNotes.clear();
+    pendingNotes.shrink_to_fit();
+    nextCheckpoint = 0;
+}
+
+const SeekIndex::Checkpoint* SeekIndex::At(double seconds) const {
+    auto it = std::upper_bound(checkpoints.begin(), checkpoints.end(), seconds,
+                               [](double value, const Checkpoint& checkpoint) { return value < checkpoint.seconds; });
+    return it == checkpoints.begin() ? nullptr : &*(it - 1);
+}
+
+size_t SeekIndex::MemoryBytes() const {
+    return checkpoints.capacity() * sizeof(Checkpoint) + heldNotes.capacity() * sizeof(HeldNote);
+}
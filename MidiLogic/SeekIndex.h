@@ -0,0 +1,83 @@
+// SeekIndex.h
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+#include "TempoMap.h"
+
+// Checkpoints of the channel state at regular points of a song, built at load
+// time. A seek lands on its exact target and takes the checkpoint at or before
+// it as the starting point: each channel's program, controllers and pitch
+// bend, and the notes held there, which the notes started between the
+// checkpoint and the target complete. The tempo at a checkpoint comes from the
+// tempo map, which already answers it per tick.
+class SeekIndex {
+public:
+    // Controllers a checkpoint restores, with their power-on values
+    static constexpr std::array<uint8_t, 14> CONTROLLERS = {1, 7, 10, 11, 64, 65, 66, 67, 71, 72, 73, 74, 91, 93};
+    static constexpr std::array<uint8_t, 14> CONTROLLER_DEFAULTS = {0, 100, 64, 127, 0, 0, 0, 0, 64, 64, 64, 64, 40, 0};
+
+    struct ChannelState {
+        uint16_t bank = 0;
+        uint8_t program = 0;
+        uint16_t pitchBend = 8192;
+        std::array<uint8_t, CONTROLLERS.size()> controllers = CONTROLLER_DEFAULTS;
+    };
+
+    // Note that started before a checkpoint and is still held at it
+    struct HeldNote {
+        uint64_t endTick;
+        uint8_t channel;
+        uint8_t key;
+        uint8_t velocity;
+    };
+
+    struct Checkpoint {
+        uint64_t tick;
+        double seconds;
+        std::array<ChannelState, 16> channels;
+        uint32_t firstHeldNote;
+        uint32_t heldNoteCount;
+    };
+
+    // Channel message as the parser found it: controller, program or pitch bend
+    struct ChannelEvent {
+        uint64_t tick;
+        uint8_t status;
+        uint8_t data1;
+        uint8_t data2;
+    };
+
+    // Building, done by the parser once the tempo map is known. Reset lays out
+    // the checkpoints, ApplyChannelEvents plays the tick-sorted channel
+    // messages into them, AddNote records a note at every checkpoint it is held
+    // across (notes of one track in start order are cheapest), Finish packs.
+    void Reset(const TempoMap& tempoMap, uint64_t totalTicks);
+    void ApplyChannelEvents(const std::vector<ChannelEvent>& events);
+    void AddNote(uint64_t startTick, uint64_t endTick, uint8_t channel, uint8_t key, uint8_t velocity);
+    void Finish();
+
+    bool Empty() const { return checkpoints.empty(); }
+
+    // The last checkpoint at or before seconds; nullptr if there is none
+    const Checkpoint* At(double seconds) const;
+
+    std::span<const HeldNote> HeldNotes(const Checkpoint& checkpoint) const {
+        return {heldNotes.data() + checkpoint.firstHeldNote, checkpoint.heldNoteCount};
+    }
+
+    size_t MemoryBytes() const;
+
+private:
+    static constexpr double MIN_INTERVAL_SECONDS = 0.25;
+    static constexpr size_t MAX_CHECKPOINTS = 4096;
+    static constexpr size_t MAX_HELD_NOTES = 128; // Per checkpoint, about the synth's polyphony
+
+    std::vector<Checkpoint> checkpoints;
+    std::vector<HeldNote> heldNotes;
+    std::vector<std::vector<HeldNote>> pendingNotes; // Per checkpoint while building
+    size_t nextCheckpoint = 0;                       // AddNote's starting guess
+};
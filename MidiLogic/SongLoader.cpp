@@ -0,0 +1,137 @@
+// SongLoader.cpp
+#include "SongLoader.h"
+#include "../utils/MappedFile.h"
+
+#include <algorithm>
+#include <iostream>
+
+SongLoader::SongLoader(std::vector<std::string> files)
+    : midiFiles(std::move(files)) {
+    worker = std::thread([this] { WorkerLoop(); });
+}
+
+SongLoader::~SongLoader() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    worker.join();
+}
+
+void SongLoader::Request(int songIndex) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        requestedIndex = songIndex;
+        // A cached song is handed over right away instead of waiting for the worker
+        published = FindCached(songIndex);
+        requestPending = published == nullptr;
+    }
+    wake.notify_one();
+}
+
+void SongLoader::Prefetch(int songIndex) {
+    if (songIndex < 0 || songIndex >= static_cast<int>(midiFiles.size())) return;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (FindCached(songIndex) != nullptr ||
+            std::find(prefetchQueue.begin(), prefetchQueue.end(), songIndex) != prefetchQueue.end()) {
+            return;
+        }
+        prefetchQueue.push_back(songIndex);
+        // Older prefetches are for songs the user already moved away from
+        while (prefetchQueue.size() > CACHE_SIZE - 1) prefetchQueue.pop_front();
+    }
+    wake.notify_one();
+}
+
+std::shared_ptr<const MidiSong> SongLoader::TakePublished() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return std::move(published);
+}
+
+std::shared_ptr<const MappedFile> SongLoader::OpenFile(int songIndex) {
+    if (songIndex < 0 || songIndex >= static_cast<int>(midiFiles.size())) return nullptr;
+    auto matches = [&](const auto& entry) { return entry.first == songIndex; };
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = std::find_if(files.begin(), files.end(), matches);
+        if (it != files.end()) {
+            files.splice(files.begin(), files, it);
+            return files.front().second;
+        }
+    }
+
+    // Mapped without the lock; if the worker and the UI race, the later mapping is dropped
+    auto file = std::make_shared<const MappedFile>(midiFiles[songIndex]);
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = std::find_if(files.begin(), files.end(), matches);
+    if (it != files.end()) return it->second;
+    files.emplace_front(songIndex, file);
+    // Players keep their own reference, so an evicted file stays mapped while one plays it
+    if (files.size() > CACHE_SIZE) files.pop_back();
+    return file;
+}
+
+void SongLoader::WorkerLoop() {
+    while (true) {
+        int songIndex;
+        bool forDisplay;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [this] { return stopping || requestPending || !prefetchQueue.empty(); });
+            if (stopping) return;
+            if (requestPending) {
+                songIndex = requestedIndex;
+                forDisplay = true;
+                requestPending = false;
+            } else {
+                songIndex = prefetchQueue.front();
+                forDisplay = false;
+                prefetchQueue.pop_front();
+            }
+            if (songIndex < 0 || songIndex >= static_cast<int>(midiFiles.size())) continue;
+            if (auto cached = FindCached(songIndex)) {
+                if (forDisplay) published = cached;
+                continue;
+            }
+        }
+
+        std::shared_ptr<const MappedFile> file = OpenFile(songIndex);
+        if (forDisplay && file->Size() >= PREVIEW_MIN_BYTES) {
+            // Ticks per quarter from the header; SMPTE files just get a larger window
+            int division = (file->Data()[12] << 8) | file->Data()[13];
+            uint64_t ticksPerQuarter = (division & 0x8000) ? 960 : std::max(division, 1);
+            Publish(songIndex, LoadMidiSong(file->Data(), file->Size(), {true, ticksPerQuarter * PREVIEW_QUARTERS}));
+            // The user may have skipped past the song while its preview was parsed
+            std::lock_guard<std::mutex> lock(mutex);
+            if (requestedIndex != songIndex) continue;
+        }
+        std::shared_ptr<const MidiSong> song = LoadMidiSong(file->Data(), file->Size());
+        std::cout << "Parsed " << midiFiles[songIndex] << ": " << song->file.notes.Size() << " notes ("
+                  << song->file.notes.MemoryBytes() / 1024 << " KB, "
+                  << song->lod.GetLevels().size() << " LOD levels " << song->lod.MemoryBytes() / 1024 << " KB)"
+                  << std::endl;
+        Publish(songIndex, song);
+        std::lock_guard<std::mutex> lock(mutex);
+        AddToCache(songIndex, std::move(song));
+    }
+}
+
+void SongLoader::Publish(int songIndex, std::shared_ptr<const MidiSong> song) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (songIndex == requestedIndex) published = std::move(song);
+}
+
+std::shared_ptr<const MidiSong> SongLoader::FindCached(int songIndex) {
+    auto it = std::find_if(cache.begin(), cache.end(), [&](const auto& entry) { return entry.first == songIndex; });
+    if (it == cache.end()) return nullptr;
+    cache.splice(cache.begin(), cache, it);
+    return cache.front().second;
+}
+
+void SongLoader::AddToCache(int songIndex, std::shared_ptr<const MidiSong> song) {
+    cache.remove_if([&](const auto& entry) { return entry.first == songIndex; });
+    cache.emplace_front(songIndex, std::move(song));
+    if (cache.size() > CACHE_SIZE) cache.pop_back();
+}
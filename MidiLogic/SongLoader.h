@@ -0,0 +1,66 @@
+// SongLoader.h
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "MidiSong.h"
+#include "../utils/MappedFile.h"
+
+// Parses songs on a background thread. The requested song is published first as
+// a preview of its opening seconds and then in full; neighbours can be
+// prefetched so that switching to them is instant.
+class SongLoader {
+public:
+    explicit SongLoader(std::vector<std::string> midiFiles);
+    SongLoader(const SongLoader&) = delete;
+    SongLoader& operator=(const SongLoader&) = delete;
+    ~SongLoader();
+
+    // Starts loading a song for display, replacing any earlier request
+    void Request(int songIndex);
+
+    // Loads a song in the background so a later Request finds it ready
+    void Prefetch(int songIndex);
+
+    // Returns the newest version of the requested song published since the
+    // last call, or nullptr. Called from the UI thread.
+    std::shared_ptr<const MidiSong> TakePublished();
+
+    // The song's file, mapped once and shared by the parser and the player that
+    // copies it in. Returns the worker's mapping when it already has one.
+    std::shared_ptr<const MappedFile> OpenFile(int songIndex);
+
+private:
+    // Files at least this large get a preview before the full parse
+    static constexpr size_t PREVIEW_MIN_BYTES = 1 << 20;
+    // Length of the preview, in quarter notes (about 20 s at 120 BPM)
+    static constexpr uint64_t PREVIEW_QUARTERS = 40;
+    static constexpr size_t CACHE_SIZE = 4;
+
+    std::vector<std::string> midiFiles;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    int requestedIndex = -1;
+    bool requestPending = false;
+    std::shared_ptr<const MidiSong> published;
+    std::deque<int> prefetchQueue;
+    std::list<std::pair<int, std::shared_ptr<const MidiSong>>> cache; // Most recently used first
+    std::list<std::pair<int, std::shared_ptr<const MappedFile>>> files; // Most recently used first
+
+    void WorkerLoop();
+    void Publish(int songIndex, std::shared_ptr<const MidiSong> song);
+
+    // Both expect the mutex to be held
+    std::shared_ptr<const MidiSong> FindCached(int songIndex);
+    void AddToCache(int songIndex, std::shared_ptr<const MidiSong> song);
+};
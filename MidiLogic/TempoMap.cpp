@@ -0,0 +1,71 @@
+// TempoMap.cpp
+#include "TempoMap.h"
+
+#include <algorithm>
+
+TempoMap midiTempoMap;
+
+void TempoMap::Build(int tpq, std::vector<TempoChange> changes) {
+    ticksPerQuarter = tpq > 0 ? tpq : 480;
+    segments.clear();
+
+    std::stable_sort(changes.begin(), changes.end(), [](const TempoChange& a, const TempoChange& b) {
+        return a.tick < b.tick;
+    });
+
+    // Songs without a tempo event at tick 0 start at the default 120 BPM
+    segments.push_back({0, 0.0, DEFAULT_MICROS_PER_QUARTER / (ticksPerQuarter * 1000000.0),
+                        DEFAULT_MICROS_PER_QUARTER});
+    for (const auto& change : changes) {
+        if (change.microsPerQuarter == 0) continue;
+        Segment& last = segments.back();
+        if (change.microsPerQuarter == last.microsPerQuarter) continue;
+        double secondsPerTick = change.microsPerQuarter / (ticksPerQuarter * 1000000.0);
+        if (change.tick == last.tick) {
+            last.secondsPerTick = secondsPerTick;
+            last.microsPerQuarter = change.microsPerQuarter;
+            continue;
+        }
+        double startSeconds = last.startSeconds + (change.tick - last.tick) * last.secondsPerTick;
+        segments.push_back({change.tick, startSeconds, secondsPerTick, change.microsPerQuarter});
+    }
+}
+
+void TempoMap::BuildFixed(double ticksPerSecond) {
+    ticksPerQuarter = static_cast<int>(ticksPerSecond / 2); // nominal, at 120 BPM
+    segments.clear();
+    double secondsPerTick = ticksPerSecond > 0 ? 1.0 / ticksPerSecond : 0.0;
+    segments.push_back({0, 0.0, secondsPerTick, DEFAULT_MICROS_PER_QUARTER});
+}
+
+void TempoMap::Clear() {
+    Build(480, {});
+}
+
+double TempoMap::TicksToSeconds(double ticks) const {
+    if (segments.empty() || ticks <= 0.0) return 0.0;
+    const Segment& segment = SegmentForTick(ticks);
+    return segment.startSeconds + (ticks - segment.tick) * segment.secondsPerTick;
+}
+
+double TempoMap::SecondsToTicks(double seconds) const {
+    if (segments.empty() || seconds <= 0.0) return 0.0;
+    auto it = std::upper_bound(segments.begin(), segments.end(), seconds, [](double s, const Segment& segment) {
+        return s < segment.startSeconds;
+    });
+    const Segment& segment = *(it - 1);
+    if (segment.secondsPerTick <= 0.0) return static_cast<double>(segment.tick);
+    return segment.tick + (seconds - segment.startSeconds) / segment.secondsPerTick;
+}
+
+double TempoMap::GetInitialBpm() const {
+    if (segments.empty()) return 60000000.0 / DEFAULT_MICROS_PER_QUARTER;
+    return 60000000.0 / segments.front().microsPerQuarter;
+}
+
+const TempoMap::Segment& TempoMap::SegmentForTick(double ticks) const {
+    auto it = std::upper_bound(segments.begin(), segments.end(), ticks, [](double t, const Segment& segment) {
+        return t < static_cast<double>(segment.tick);
+    });
+    return *(it - 1);
+}
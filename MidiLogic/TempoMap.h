@@ -0,0 +1,50 @@
+// TempoMap.h
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+// Piecewise-constant tempo of a MIDI file, compiled once per file. Each segment
+// stores the time at which it starts, so tick/second conversion is a binary
+// search instead of a replay of the tempo events.
+class TempoMap {
+public:
+    struct TempoChange {
+        uint64_t tick;
+        uint32_t microsPerQuarter;
+    };
+
+    struct Segment {
+        uint64_t tick;         // First tick of the segment
+        double startSeconds;   // Time of that tick from the start of the song
+        double secondsPerTick;
+        uint32_t microsPerQuarter;
+    };
+
+    // Builds the segments from tempo events in any order; when several events
+    // share a tick, the last one in the list wins
+    void Build(int ticksPerQuarter, std::vector<TempoChange> changes);
+
+    // Fixed rate used for SMPTE time division files, which ignore tempo events
+    void BuildFixed(double ticksPerSecond);
+
+    void Clear();
+
+    double TicksToSeconds(double ticks) const;
+    double SecondsToTicks(double seconds) const;
+
+    // Tempo in effect at the start of the song
+    double GetInitialBpm() const;
+    int GetTicksPerQuarter() const { return ticksPerQuarter; }
+    const std::vector<Segment>& GetSegments() const { return segments; }
+
+private:
+    static constexpr uint32_t DEFAULT_MICROS_PER_QUARTER = 500000; // 120 BPM
+
+    int ticksPerQuarter = 480;
+    std::vector<Segment> segments;
+
+    const Segment& SegmentForTick(double ticks) const;
+};
+
+extern TempoMap midiTempoMap;
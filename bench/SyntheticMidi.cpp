@@ -0,0 +1,112 @@
+// SyntheticMidi.cpp
+#include "SyntheticMidi.h"
+
+namespace {
+    constexpr uint16_t TICKS_PER_QUARTER = 480;
+
+    void WriteU16(std::vector<uint8_t>& out, uint16_t value) {
+        out.push_back(static_cast<uint8_t>(value >> 8));
+        out.push_back(static_cast<uint8_t>(value));
+    }
+
+    void WriteU32(std::vector<uint8_t>& out, uint32_t value) {
+        for (int shift = 24; shift >= 0; shift -= 8) out.push_back(static_cast<uint8_t>(value >> shift));
+    }
+
+    void WriteVarLen(std::vector<uint8_t>& out, uint32_t value) {
+        uint8_t bytes[4];
+        int count = 0;
+        do {
+            bytes[count++] = static_cast<uint8_t>(value & 0x7F);
+            value >>= 7;
+        } while (value != 0 && count < 4);
+        while (count > 1) out.push_back(bytes[--count] | 0x80);
+        out.push_back(bytes[0]);
+    }
+
+    // Wraps a track body in an MTrk chunk, adding the end-of-track event
+    void AppendTrack(std::vector<uint8_t>& out, std::vector<uint8_t>& body) {
+        body.insert(body.end(), {0x00, 0xFF, 0x2F, 0x00});
+        out.insert(out.end(), {'M', 'T', 'r', 'k'});
+        WriteU32(out, static_cast<uint32_t>(body.size()));
+        out.insert(out.end(), body.begin(), body.end());
+    }
+
+    std::vector<uint8_t> ConductorTrack(const SyntheticMidiSpec& spec) {
+        std::vector<uint8_t> body;
+        uint64_t songTicks = spec.chordsPerTrack * spec.stepTicks;
+        int changes = spec.tempoChanges > 0 ? spec.tempoChanges : 1;
+        uint32_t interval = static_cast<uint32_t>(songTicks / changes);
+        for (int i = 0; i < changes; ++i) {
+            // Alternates between 120 and 150 BPM
+            uint32_t microsPerQuarter = (i % 2 == 0) ? 500000 : 400000;
+            WriteVarLen(body, i == 0 ? 0 : interval);
+            body.insert(body.end(), {0xFF, 0x51, 0x03});
+            body.push_back(static_cast<uint8_t>(microsPerQuarter >> 16));
+            body.push_back(static_cast<uint8_t>(microsPerQuarter >> 8));
+            body.push_back(static_cast<uint8_t>(microsPerQuarter));
+        }
+        return body;
+    }
+
+    std::vector<uint8_t> NoteTrack(const SyntheticMidiSpec& spec, int track) {
+        std::vector<uint8_t> body;
+        body.reserve(spec.chordsPerTrack * spec.chordSize * 8);
+        // Channel 9 is drums and never drawn, so melodic tracks skip it
+        int channel = track % 15;
+        if (channel >= 9) ++channel;
+        uint32_t random = 12345u + static_cast<uint32_t>(track) * 7919u;
+
+        std::vector<uint8_t> chord(spec.chordSize);
+        for (uint64_t step = 0; step < spec.chordsPerTrack; ++step) {
+            // Fifths above a random root, so keys within a chord never repeat
+            random = random * 1664525u + 1013904223u;
+            uint32_t root = (random >> 24) % 88;
+            for (int n = 0; n < spec.chordSize; ++n) {
+                chord[n] = static_cast<uint8_t>(21 + (root + n * 7) % 88);
+            }
+            for (int n = 0; n < spec.chordSize; ++n) {
+                WriteVarLen(body, (n == 0 && step > 0) ? spec.stepTicks - spec.noteTicks : 0);
+                if (n == 0) body.push_back(static_cast<uint8_t>(0x90 | channel));
+                body.push_back(chord[n]);
+                body.push_back(100);
+            }
+            for (int n = 0; n < spec.chordSize; ++n) {
+                WriteVarLen(body, n == 0 ? spec.noteTicks : 0);
+                body.push_back(chord[n]);
+                body.push_back(0);
+            }
+        }
+        return body;
+    }
+
+    std::vector<uint8_t> WholeSongNoteTrack(const SyntheticMidiSpec& spec) {
+        std::vector<uint8_t> body;
+        uint64_t songTicks = spec.chordsPerTrack * spec.stepTicks;
+        body.insert(body.end(), {0x00, 0x90, 60, 100});
+        WriteVarLen(body, static_cast<uint32_t>(songTicks));
+        body.insert(body.end(), {0x80, 60, 0});
+        return body;
+    }
+}
+
+std::vector<uint8_t> GenerateSyntheticMidi(const SyntheticMidiSpec& spec) {
+    std::vector<uint8_t> out;
+    out.insert(out.end(), {'M', 'T', 'h', 'd'});
+    WriteU32(out, 6);
+    WriteU16(out, 1);
+    WriteU16(out, static_cast<uint16_t>(spec.tracks + 1 + (spec.wholeSongNote ? 1 : 0)));
+    WriteU16(out, TICKS_PER_QUARTER);
+
+    std::vector<uint8_t> body = ConductorTrack(spec);
+    AppendTrack(out, body);
+    for (int track = 0; track < spec.tracks; ++track) {
+        body = NoteTrack(spec, track);
+        AppendTrack(out, body);
+    }
+    if (spec.wholeSongNote) {
+        body = WholeSongNoteTrack(spec);
+        AppendTrack(out, body);
+    }
+    return out;
+}
@@ -0,0 +1,29 @@
+// SyntheticMidi.h
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Shape of a generated MIDI file. Each track plays chords of chordSize notes
+// every stepTicks; a conductor track carries tempoChanges tempo events. With
+// wholeSongNote, one more track holds a single note from start to end.
+struct SyntheticMidiSpec {
+    std::string name;
+    int tracks;
+    uint64_t chordsPerTrack;
+    int chordSize;      // At most 88
+    uint32_t stepTicks;
+    uint32_t noteTicks; // Must be shorter than stepTicks
+    int tempoChanges;
+    bool wholeSongNote = false;
+
+    uint64_t NoteCount() const {
+        return static_cast<uint64_t>(tracks) * chordsPerTrack * chordSize + (wholeSongNote ? 1 : 0);
+    }
+};
+
+// Builds a format 1 file with 480 ticks per quarter. Note-offs are written as
+// running-status note-ons with velocity 0, as most sequencers do. The output
+// only depends on the spec.
+std::vector<uint8_t> GenerateSyntheticMidi(const SyntheticMidiSpec& spec);
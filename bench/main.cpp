@@ -0,0 +1,266 @@
+// bench/main.cpp
+// Headless benchmarks for parsing, keyboard layout and frame preparation.
+// Needs no window or audio device.
+//
+// Usage: sonique_bench [--baselines FILE] [--write-baselines] [--tolerance FRACTION]
+//                      [--memory-tolerance FRACTION] [--filter TEXT]
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/resource.h>
+
+#include "SyntheticMidi.h"
+#include "../MidiLogic/KeyEventQueue.h"
+#include "../MidiLogic/KeyStates.h"
+#include "../MidiLogic/MidiParser.h"
+#include "../MidiLogic/MidiSong.h"
+#include "../ui/BlockFrame.h"
+#include "../ui/KeyboardLayout.h"
+#include "../ui/PianoKey.h"
+#include "../utils/MidiUtils.h"
+#include "../utils/SongSearch.h"
+
+#ifndef SONIQUE_BENCH_BASELINES
+#define SONIQUE_BENCH_BASELINES "bench/baselines.txt"
+#endif
+
+// Referenced by the MIDI event handler in MidiUtils
+KeyStates midiKeyStates;
+KeyEventQueue midiKeyEvents;
+
+namespace {
+    using Clock = std::chrono::steady_clock;
+
+    // Each benchmark repeats until it has run at least this long
+    constexpr double MIN_SECONDS = 0.5;
+
+    struct BenchResult {
+        std::string name;
+        double throughput; // Higher is better
+        std::string unit;
+        long maxRssKb;     // Process high-water mark after the benchmark
+    };
+
+    struct Baseline {
+        double throughput;
+        long maxRssKb;
+    };
+
+    long MaxRssKb() {
+        rusage usage{};
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return usage.ru_maxrss / 1024; // Bytes on macOS
+#else
+        return usage.ru_maxrss;
+#endif
+    }
+
+    // Runs body until MIN_SECONDS have passed; body returns the work units it did
+    double Measure(const std::function<uint64_t()>& body) {
+        uint64_t units = 0;
+        Clock::time_point start = Clock::now();
+        double elapsed = 0.0;
+        do {
+            units += body();
+            elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+        } while (elapsed < MIN_SECONDS);
+        return units / elapsed;
+    }
+
+    std::map<std::string, Baseline> LoadBaselines(const std::string& path) {
+        std::map<std::string, Baseline> baselines;
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            std::stringstream stream(line);
+            std::string name;
+            Baseline baseline{};
+            if (stream >> name >> baseline.throughput >> baseline.maxRssKb) baselines[name] = baseline;
+        }
+        return baselines;
+    }
+
+    bool SaveBaselines(const std::string& path, const std::map<std::string, Baseline>& baselines) {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file) return false;
+        file << "# name throughput max_rss_kb. Machine specific. Re-record only the rows a change affects, in that change:\n"
+                "# sonique_bench --write-baselines --filter NAME\n";
+        for (const auto& [name, baseline] : baselines) {
+            file << name << ' ' << std::fixed << std::setprecision(1) << baseline.throughput << ' '
+                    << baseline.maxRssKb << '\n';
+        }
+        return static_cast<bool>(file);
+    }
+
+    const std::vector<SyntheticMidiSpec> specs = {
+        // name, tracks, chords per track, chord size, step, note length, tempo changes
+        {"sparse", 2, 500, 1, 480, 240, 4},
+        {"dense", 16, 5000, 4, 60, 45, 200},
+        {"huge", 16, 40000, 4, 30, 20, 2000}, // 2.56 million notes
+        {"black", 32, 10000, 8, 8, 6, 200},   // Same count, tens of thousands visible per frame
+        {"held", 16, 5000, 4, 60, 45, 200, true}, // Dense, plus one note held from start to end
+    };
+}
+
+int main(int argc, char** argv) {
+    std::string baselinePath = SONIQUE_BENCH_BASELINES;
+    bool writeBaselines = false;
+    double tolerance = 0.25;
+    // The high-water mark depends on allocator timing, so it gets more slack
+    double memoryTolerance = 0.5;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--baselines") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--write-baselines") == 0) {
+            writeBaselines = true;
+        } else if (std::strcmp(argv[i], "--tolerance") == 0 && i + 1 < argc) {
+            tolerance = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--memory-tolerance") == 0 && i + 1 < argc) {
+            memoryTolerance = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            filter = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0]
+                    << " [--baselines FILE] [--write-baselines] [--tolerance FRACTION]"
+                    << " [--memory-tolerance FRACTION] [--filter TEXT]" << std::endl;
+            return 2;
+        }
+    }
+
+    std::vector<BenchResult> results;
+    auto run = [&](const std::string& name, const std::string& unit, const std::function<uint64_t()>& body) {
+        if (!filter.empty() && name.find(filter) == std::string::npos) return;
+        // The loaders log every file they parse; keep that out of the report
+        std::ostringstream discard;
+        std::streambuf* console = std::cout.rdbuf(discard.rdbuf());
+        double throughput = Measure(body);
+        std::cout.rdbuf(console);
+        results.push_back({name, throughput, unit, MaxRssKb()});
+        std::cout << std::left << std::setw(20) << name << std::right << std::setw(16) << std::fixed
+                << std::setprecision(1) << throughput << ' ' << std::setw(10) << std::left << unit
+                << std::right << std::setw(10) << results.back().maxRssKb << " KB max RSS" << std::endl;
+    };
+
+    // Keyboard layout, alternating between two window sizes so every call rebuilds
+    KeyboardLayout resizedLayout;
+    bool wide = false;
+    run("layout", "layouts/s", [&] {
+        wide = !wide;
+        resizedLayout.Update(wide ? 1920 : 1220, 800);
+        return uint64_t{1};
+    });
+
+    // Song search, typing a query one key at a time over a large library
+    std::vector<SongInfo> library;
+    const char* syllables[] = {"moon", "light", "so", "na", "ta", "noc", "turne", "waltz", "pre", "lude", "etude", "rag"};
+    for (int i = 0; i < 20000; ++i) {
+        std::string title;
+        for (int w = 0, seed = i; w < 3; ++w, seed = seed * 7 + 3) {
+            title += std::string(syllables[seed % 12]) + syllables[(seed / 12) % 12] + ' ';
+        }
+        library.push_back({"song" + std::to_string(i) + ".mid", title + std::to_string(i), "Artist " + std::to_string(i % 500)});
+    }
+    SongSearch songSearch;
+    songSearch.Build(library);
+    const std::string typedQuery = "moonlight sona 12";
+    run("search", "keys/s", [&] {
+        for (size_t length = 1; length <= typedQuery.size(); ++length) songSearch.Search(typedQuery.substr(0, length));
+        songSearch.Search("");
+        return static_cast<uint64_t>(typedQuery.size() + 1);
+    });
+
+    std::filesystem::path tempDir = std::filesystem::temp_directory_path() / "sonique_bench";
+    std::filesystem::create_directories(tempDir);
+
+    for (const auto& spec : specs) {
+        std::vector<uint8_t> data = GenerateSyntheticMidi(spec);
+        std::string midiPath = (tempDir / (spec.name + ".mid")).string();
+        std::ofstream(midiPath, std::ios::binary).write(reinterpret_cast<const char*>(data.data()),
+                                                        static_cast<std::streamsize>(data.size()));
+
+        run("parse_" + spec.name, "notes/s", [&] {
+            return ParseMidiFile(data.data(), data.size()).stats.noteCount;
+        });
+        run("load_" + spec.name, "notes/s", [&] {
+            LoadMidiBlocks(data.data(), data.size());
+            return static_cast<uint64_t>(spec.NoteCount());
+        });
+        run("tempo_" + spec.name, "files/s", [&] {
+            GetMidiInitialTempoBPM(midiPath);
+            return uint64_t{1};
+        });
+
+        // Frames spread evenly over the whole song, drawn into a recording sink
+        std::shared_ptr<MidiSong> song = LoadMidiSong(data.data(), data.size());
+        KeyboardLayout layout;
+        layout.Update(1220, 800);
+        std::vector<BlockQuad> quads;
+        constexpr uint64_t frames = 2000;
+        double secondsPerFrame = song->file.stats.durationSeconds / frames;
+        run("frame_" + spec.name, "frames/s", [&] {
+            for (uint64_t frame = 0; frame < frames; ++frame) {
+                PrepareBlockFrame(*song, layout, frame * secondsPerFrame, 200.0f, layout.GetKeyboardY(), quads);
+            }
+            return frames;
+        });
+
+        std::filesystem::remove(midiPath);
+    }
+    std::filesystem::remove(tempDir);
+
+    std::map<std::string, Baseline> baselines = LoadBaselines(baselinePath);
+    if (writeBaselines) {
+        // Benchmarks skipped by --filter keep their recorded values
+        for (const auto& result : results) baselines[result.name] = {result.throughput, result.maxRssKb};
+        if (!SaveBaselines(baselinePath, baselines)) {
+            std::cerr << "Could not write " << baselinePath << std::endl;
+            return 1;
+        }
+        std::cout << "Baselines written to " << baselinePath << std::endl;
+        return 0;
+    }
+
+    if (baselines.empty()) {
+        std::cout << "No baselines in " << baselinePath << "; run with --write-baselines to record them" << std::endl;
+        return 0;
+    }
+    int regressions = 0;
+    int unchecked = 0;
+    for (const auto& result : results) {
+        auto it = baselines.find(result.name);
+        if (it == baselines.end()) {
+            // A benchmark without a baseline can never regress; say so instead of passing it silently
+            std::cout << "NO BASELINE " << result.name << "; record it with --write-baselines" << std::endl;
+            ++unchecked;
+            continue;
+        }
+        const Baseline& baseline = it->second;
+        if (result.throughput < baseline.throughput * (1.0 - tolerance)) {
+            std::cout << "REGRESSION " << result.name << ": " << result.throughput << ' ' << result.unit
+                    << " vs baseline " << baseline.throughput << std::endl;
+            ++regressions;
+        }
+        if (result.maxRssKb > baseline.maxRssKb * (1.0 + memoryTolerance)) {
+            std::cout << "REGRESSION " << result.name << ": " << result.maxRssKb << " KB max RSS vs baseline "
+                    << baseline.maxRssKb << " KB" << std::endl;
+            ++regressions;
+        }
+    }
+    std::cout << regressions << " regression(s) against " << baselinePath;
+    if (unchecked > 0) std::cout << ", " << unchecked << " benchmark(s) without a baseline";
+    std::cout << std::endl;
+    return regressions == 0 ? 0 : 1;
+}
@@ -1,5 +1,6 @@
 #include "raylib.h"
 #include <array>
+#include <chrono>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -8,39 +9,96 @@
 #define FLUID_PLAYER_TEMPO_EXTERNAL_BPM 1
 #endif
 #include <fstream>
+#ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
+#endif
 #include <filesystem>
 
 #include "utils/MidiUtils.h"
+#include "utils/LibraryIndex.h"
 #include "ui/PianoKey.h"
 #include "utils/SongInfo.h"
 #include "utils/SoundFontUtils.h"
+#include "utils/SoundFontManager.h"
+#include "utils/OfflineRenderer.h"
+#include "utils/AudioConfig.h"
+#include "utils/SynthProfile.h"
+#include "utils/SynthTuner.h"
 #include "ui/PianoPage.h"
 #include "ui/MainMenuPage.h"
+#include "ui/PerfHud.h"
+#include "ui/FrameScheduler.h"
+#include "MidiLogic/KeyStates.h"
+#include "MidiLogic/KeyEventQueue.h"
+#include "MidiLogic/MidiInput.h"
+#include "MidiLogic/PlayerManager.h"
+#include "MidiLogic/PlaybackClock.h"
 
 constexpr bool showKeyLabels = true;
 // Add this at global scope in main.cpp (outside any function)
-std::vector<std::vector<bool> > midiKeyStates(16, std::vector<bool>(NUM_TOTAL_KEYS, false));
+KeyStates midiKeyStates;
+KeyStates liveKeyStates; // Kept apart so song changes and seeks leave held keys lit
+KeyEventQueue midiKeyEvents;
 enum class AppPage { MainMenu, Piano };
 
 
-int main() {
-    // --- FluidSynth and MIDI setup ---
-    fluid_settings_t *settings = new_fluid_settings();
-    fluid_synth_t *synth = new_fluid_synth(settings);
-    fluid_audio_driver_t *adriver = new_fluid_audio_driver(settings, synth);
+// Renders every MIDI file to WAV without opening a window or an audio device:
+//   Sonique --render [outputDir] [--threads N] [--soundfont file.sf2]
+int RenderLibrary(int argc, char **argv, const std::vector<std::string> &midiFiles, const std::string &soundFontDir) {
+    std::string outputDir = std::string(getenv("HOME")) + "/Documents/Sonique/renders";
+    OfflineRenderOptions options;
+    options.soundFontPath = soundFontDir + "/general.sf2";
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--threads" && i + 1 < argc) {
+            options.threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (arg == "--soundfont" && i + 1 < argc) {
+            options.soundFontPath = argv[++i];
+        } else {
+            outputDir = arg;
+        }
+    }
+    std::filesystem::create_directories(outputDir);
+
+    std::vector<OfflineRenderJob> jobs;
+    for (const auto &midiPath: midiFiles) {
+        std::string name = std::filesystem::path(midiPath).stem().string();
+        jobs.push_back({midiPath, outputDir + "/" + name + ".wav"});
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<OfflineRenderResult> results = RenderMidiFiles(jobs, options);
+    double wallSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double audioSeconds = 0.0;
+    double renderSeconds = 0.0;
+    int failed = 0;
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (!results[i].ok) {
+            std::cerr << "Failed to render " << jobs[i].midiPath << std::endl;
+            ++failed;
+            continue;
+        }
+        audioSeconds += results[i].audioSeconds;
+        renderSeconds += results[i].renderSeconds;
+        std::cout << jobs[i].wavPath << ": " << results[i].audioSeconds << " s of audio in "
+                << results[i].renderSeconds << " s (" << results[i].audioSeconds / results[i].renderSeconds
+                << "x realtime)" << std::endl;
+    }
+    // Synthesis cost of the SoundFont, independent of how many workers ran
+    std::cout << "Rendered " << jobs.size() - failed << " files with " << options.soundFontPath << ": "
+            << (renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0) << "x realtime per worker, "
+            << wallSeconds << " s wall time" << std::endl;
+    return failed == 0 ? 0 : 1;
+}
 
+
+int main(int argc, char **argv) {
     std::string soundFontDir = std::string(getenv("HOME")) + "/Documents/Sonique/soundFonts";
     if (!EnsureSoundFontDir(soundFontDir)) {
         return 0;
     }
     std::vector<std::string> loadedSoundFonts = ScanSoundFonts(soundFontDir);
-    int general = LoadSoundFont(synth, soundFontDir + "/general.sf2", 1);
-
-    for (int i = 1; i < 16; ++i) {
-        if (i == 9) continue;
-        fluid_synth_program_select(synth, i, general, 0, 0);
-    }
 
     std::vector<std::string> loadedMidiFiles;
     std::string midiDir = std::string(getenv("HOME")) + "/Documents/Sonique/midi";
@@ -61,16 +119,15 @@ int main() {
         }
     }
 
-    std::vector<SongInfo> songInfos = LoadSongInfos(std::string(getenv("HOME")) + "/Documents/Sonique/songinfo");
+    SongInfoMap songInfos = LoadSongInfos(std::string(getenv("HOME")) + "/Documents/Sonique/songinfo");
 
     std::vector<SongInfo> loadedSongInfos;
+    loadedSongInfos.reserve(loadedMidiFiles.size());
     for (const auto &midiPath: loadedMidiFiles) {
         std::string midiFile = midiPath.substr(midiPath.find_last_of('/') + 1);
-        auto it = std::find_if(songInfos.begin(), songInfos.end(), [&](const SongInfo &s) {
-            return s.midiFile == midiFile;
-        });
+        auto it = songInfos.find(midiFile);
         if (it != songInfos.end()) {
-            loadedSongInfos.push_back(*it);
+            loadedSongInfos.push_back(it->second);
         } else {
             loadedSongInfos.push_back({midiFile, midiFile, "Unknown"});
         }
@@ -81,57 +138,118 @@ int main() {
         return 1;
     }
 
-    std::vector<int> midiBpms;
-    for (const auto &path: loadedMidiFiles) {
-        int bpm = GetMidiInitialTempoBPM(path);
-        midiBpms.push_back(bpm > 0 ? bpm : 120);
+    if (argc > 1 && std::string(argv[1]) == "--render") {
+        return RenderLibrary(argc, argv, loadedMidiFiles, soundFontDir);
     }
 
-    // --- MIDI player setup ---
-    for (int ch = 0; ch < 16; ++ch) {
-        for (int k = 0; k < 88; ++k) {
-            midiKeyStates[ch][k] = false;
-        }
+    // --- FluidSynth and MIDI setup ---
+    fluid_settings_t *settings = new_fluid_settings();
+    // Buffer sizes decide the output latency, which the falling notes are delayed by
+    AudioConfig audioConfig = LoadAudioConfig(std::string(getenv("HOME")) + "/Documents/Sonique/audio.cfg", settings);
+    ApplyAudioConfig(settings, audioConfig);
+    std::cout << "Audio: " << audioConfig.periods << " x " << audioConfig.periodSize << " frames at "
+            << audioConfig.sampleRate << " Hz, " << OutputLatencySeconds(audioConfig) * 1000.0 << " ms output latency"
+            << std::endl;
+    // Polyphony, cores and effects bound the synth's CPU use; the tuner lowers them live under load
+    SynthProfile synthProfile = LoadSynthProfile(std::string(getenv("HOME")) + "/Documents/Sonique/synth.cfg");
+    // The first run writes the defaults out, so there is a file to edit
+    if (!std::filesystem::exists(synthProfile.path)) SaveSynthProfile(synthProfile);
+    ApplySynthProfile(settings, synthProfile);
+    std::cout << "Synth: polyphony " << synthProfile.polyphony << ", " << synthProfile.cpuCores << " cores"
+            << (synthProfile.autoTune ? ", auto-tuned" : "") << std::endl;
+    SoundFontManager::Configure(settings);
+    fluid_synth_t *synth = new_fluid_synth(settings);
+    SynthTuner synthTuner(synth, synthProfile);
+    // Player ticks advance with rendered samples, which the playback clock anchors to
+    fluid_settings_setstr(settings, "player.timing-source", "sample");
+    PlaybackClock playbackClock(settings, synth);
+    // The window opens while the SoundFont loads; general.sf2 is the default when present
+    SoundFontManager soundFonts(synth, loadedSoundFonts);
+    auto general = std::find(loadedSoundFonts.begin(), loadedSoundFonts.end(), soundFontDir + "/general.sf2");
+    if (loadedSoundFonts.empty()) {
+        std::cerr << "No SoundFonts found in directory: " << soundFontDir << std::endl;
+    } else {
+        soundFonts.Request(general != loadedSoundFonts.end() ? static_cast<int>(general - loadedSoundFonts.begin()) : 0);
     }
-    int currentSongIndex = 0;
-    fluid_player_t *player = new_fluid_player(synth);
-    fluid_player_add(player, loadedMidiFiles[currentSongIndex].c_str());
-    fluid_player_set_playback_callback(player, midi_event_handler, synth);
 
-    int tempo = midiBpms[currentSongIndex];
-    fluid_player_set_tempo(player, FLUID_PLAYER_TEMPO_EXTERNAL_BPM, tempo);
+    // Live input plays straight into the synth from the MIDI driver's thread
+    MidiInput midiInput(settings, synth, liveKeyStates, playbackClock, OutputLatencySeconds(audioConfig));
+
+    // Metadata comes from the library cache; only new or changed files are parsed
+    std::vector<SongMetadata> songMetadata = IndexMidiLibrary(
+        loadedMidiFiles, std::string(getenv("HOME")) + "/Documents/Sonique/library.cache");
+    std::vector<int> midiBpms;
+    for (const auto &metadata: songMetadata) {
+        midiBpms.push_back(metadata.bpm > 0 ? metadata.bpm : 120);
+    }
 
+    // --- MIDI player setup ---
+    midiKeyStates.Clear();
+    // Players are created per song by the piano page and deleted when replaced
+    PlayerManager players(synth, midi_event_handler, synth);
 
     // --- Window and UI ---
+    // --uncapped draws every iteration as fast as possible, for benchmarking
+    bool uncapped = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--uncapped") uncapped = true;
+    }
     const int initialWidth = 1220;
     const int initialHeight = 800;
+    frameScheduler.Configure(uncapped);
     InitWindow(initialWidth, initialHeight, "Sonique");
     SetWindowState(FLAG_WINDOW_RESIZABLE);
+    frameScheduler.Start();
 
 
     AppPage currentPage = AppPage::MainMenu;
     PianoPage pianoPage(
-        synth, player, loadedMidiFiles, loadedSongInfos, midiBpms, midiKeyStates
+        synth, players, loadedMidiFiles, loadedSongInfos, midiBpms, midiKeyStates, liveKeyStates, midiKeyEvents,
+        audioConfig, playbackClock, soundFonts
     );
     MainMenuPage mainMenu([&]() { currentPage = AppPage::Piano; });
 
+    perfHud.AttachSynth(synth);
+    perfHud.AttachInputLatency(&midiInput.GetLatencyHistogram());
+    perfHud.AttachSynthTuner(&synthTuner);
+
     while (!WindowShouldClose()) {
-        switch (currentPage) {
+        perfHud.BeginFrame();
+        if (IsKeyPressed(KEY_F3)) perfHud.Toggle();
+        synthTuner.Update(playbackClock.GetLateBuffers());
+        AppPage page = currentPage;
+        switch (page) {
             case AppPage::MainMenu:
                 mainMenu.HandleInput();
                 mainMenu.Update();
-                mainMenu.Draw();
                 break;
             case AppPage::Piano:
                 pianoPage.HandleInput();
                 pianoPage.Update();
-                pianoPage.Draw();
                 break;
         }
+        if (frameScheduler.ShouldDraw()) {
+            switch (page) {
+                case AppPage::MainMenu:
+                    mainMenu.Draw();
+                    break;
+                case AppPage::Piano:
+                    pianoPage.Draw();
+                    break;
+            }
+        } else {
+            perfHud.DiscardFrame();
+            frameScheduler.WaitForEvents();
+        }
+        // A page that was just switched to is shown on the next iteration
+        if (page != currentPage) frameScheduler.RequestRedraw();
     }
 
     // --- Cleanup ---
-    delete_fluid_audio_driver(adriver);
+    midiInput.Close();
+    soundFonts.Stop();
+    players.Clear();
+    playbackClock.Close();
     delete_fluid_synth(synth);
     delete_fluid_settings(settings);
     CloseWindow();
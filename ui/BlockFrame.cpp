@@ -0,0 +1,33 @@
+// BlockFrame.cpp
+#include "BlockFrame.h"
+
+void PrepareBlockFrame(const MidiSong& song, const KeyboardLayout& layout, double currentTime, float fallSpeed,
+                       int keyboardY, std::vector<BlockQuad>& quads) {
+    quads.clear();
+    // Only blocks between the keyboard line and the top of the window are visible
+    double visibleSeconds = static_cast<double>(keyboardY) / fallSpeed;
+    // Dense windows come from a LOD level, so each key column stays bounded
+    NoteView view = SelectNotes(song, currentTime, currentTime + visibleSeconds, fallSpeed);
+    NoteIndex::Range visible = view.range;
+    const NoteStore& notes = *view.notes;
+    const float* startTimes = notes.StartTimes();
+    const float* durations = notes.Durations();
+    float now = static_cast<float>(currentTime);
+    // Long blocks started before the main range, so they come first in draw order
+    size_t longCount = visible.longLast - visible.longFirst;
+    size_t candidates = longCount + (visible.last - visible.first);
+    for (size_t n = 0; n < candidates; ++n) {
+        size_t i = n < longCount ? view.index->LongNote(visible.longFirst + n) : visible.first + (n - longCount);
+        if (startTimes[i] + durations[i] < now) continue;
+        const PianoKey* key = layout.KeyForMidi(notes.Key(i));
+        if (key == nullptr) continue;
+
+        // At its start time the bottom of a block touches the keyboard, then it moves down
+        float blockHeight = durations[i] * fallSpeed;
+        float blockY = keyboardY - blockHeight + (now - startTimes[i]) * fallSpeed;
+        quads.push_back({
+            Rectangle{key->rect.x, blockY, key->rect.width, blockHeight},
+            layout.BlockColor(notes.Key(i), notes.Channel(i))
+        });
+    }
+}
@@ -0,0 +1,18 @@
+// BlockFrame.h
+#pragma once
+
+#include <vector>
+#include "raylib.h"
+#include "KeyboardLayout.h"
+#include "../MidiLogic/MidiSong.h"
+
+// A falling block as it is drawn this frame
+struct BlockQuad {
+    Rectangle rect;
+    Color color;
+};
+
+// Collects the blocks of a song visible at currentTime into quads, in draw
+// order. Kept apart from drawing so a frame can be prepared without a window.
+void PrepareBlockFrame(const MidiSong& song, const KeyboardLayout& layout, double currentTime, float fallSpeed,
+                       int keyboardY, std::vector<BlockQuad>& quads);
@@ -0,0 +1,54 @@
+// FrameScheduler.cpp
+#include "FrameScheduler.h"
+#include "raylib.h"
+
+FrameScheduler frameScheduler;
+
+void FrameScheduler::Configure(bool uncapped) {
+    this->uncapped = uncapped;
+    if (!uncapped) SetConfigFlags(FLAG_VSYNC_HINT);
+}
+
+void FrameScheduler::Start() {
+    UpdateRefreshRate();
+    wasFocused = IsWindowFocused();
+    redrawRequested = true;
+}
+
+void FrameScheduler::UpdateRefreshRate() {
+    int rate = GetMonitorRefreshRate(GetCurrentMonitor());
+    refreshRate = rate > 0 ? rate : FALLBACK_REFRESH_RATE;
+    // The limiter backs up VSync where the driver ignores the hint
+    SetTargetFPS(uncapped ? 0 : refreshRate);
+}
+
+bool FrameScheduler::InputChanged() {
+    bool focused = IsWindowFocused();
+    bool focusChanged = focused != wasFocused;
+    wasFocused = focused;
+    if (IsWindowResized()) {
+        // The window may have moved to another monitor as well
+        UpdateRefreshRate();
+        return true;
+    }
+    if (focusChanged || GetKeyPressed() != 0 || GetMouseWheelMove() != 0.0f) return true;
+    Vector2 mouseDelta = GetMouseDelta();
+    if (mouseDelta.x != 0.0f || mouseDelta.y != 0.0f) return true;
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_BACK; ++button) {
+        if (IsMouseButtonDown(button) || IsMouseButtonReleased(button)) return true;
+    }
+    return false;
+}
+
+bool FrameScheduler::ShouldDraw() {
+    // Input is checked every iteration so focus changes are never missed
+    bool draw = InputChanged() || redrawRequested || uncapped;
+    redrawRequested = false;
+    // Nothing is visible, but pages keep updating so playback continues
+    return draw && (uncapped || !IsWindowMinimized());
+}
+
+void FrameScheduler::WaitForEvents() {
+    WaitTime(1.0 / refreshRate);
+    PollInputEvents();
+}
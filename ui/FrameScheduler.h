@@ -0,0 +1,41 @@
+// FrameScheduler.h
+#pragma once
+
+// Decides which loop iterations draw. While something moves (playback, the
+// latency test, held keys) frames run at the display refresh rate; otherwise
+// the loop only polls input and sleeps, and draws once when input, a resize
+// or a page's RequestRedraw() says the picture changed. Uncapped mode draws
+// every iteration with no frame limit, for benchmarking.
+class FrameScheduler {
+public:
+    // Call before InitWindow(); sets the window flags for the mode
+    void Configure(bool uncapped);
+
+    // Call after InitWindow()
+    void Start();
+
+    // Draw on this iteration; pages call it every Update() while animating
+    void RequestRedraw() { redrawRequested = true; }
+
+    // Call after the pages' Update(); true if this iteration should draw
+    bool ShouldDraw();
+
+    // Call instead of drawing: sleeps about one refresh interval, then polls input
+    void WaitForEvents();
+
+    bool IsUncapped() const { return uncapped; }
+    int GetRefreshRate() const { return refreshRate; }
+
+private:
+    static constexpr int FALLBACK_REFRESH_RATE = 60;
+
+    bool uncapped = false;
+    bool redrawRequested = true;
+    bool wasFocused = true;
+    int refreshRate = FALLBACK_REFRESH_RATE;
+
+    bool InputChanged();
+    void UpdateRefreshRate();
+};
+
+extern FrameScheduler frameScheduler;
@@ -0,0 +1,36 @@
+// KeyboardLayout.cpp
+#include "KeyboardLayout.h"
+#include "../MidiLogic/MidiBlock.h"
+
+KeyboardLayout::KeyboardLayout() {
+    keyIndexForMidi.fill(-1);
+    for (int channel = 0; channel < 16; ++channel) {
+        MidiColor color = MidiBlock::colorForChannel(channel);
+        for (int black = 0; black < 2; ++black) {
+            float shade = black ? 0.6f : 1.0f;
+            blockColors[channel * 2 + black] = Color{
+                static_cast<unsigned char>(color.r * shade * 255),
+                static_cast<unsigned char>(color.g * shade * 255),
+                static_cast<unsigned char>(color.b * shade * 255),
+                static_cast<unsigned char>(color.a * 255)
+            };
+        }
+    }
+}
+
+bool KeyboardLayout::Update(int width, int height) {
+    if (width == windowWidth && height == windowHeight) return false;
+    windowWidth = width;
+    windowHeight = height;
+
+    keyboardHeight = static_cast<int>(width / KEYBOARD_ASPECT);
+    if (keyboardHeight > height) keyboardHeight = height;
+    keyboardY = height - keyboardHeight;
+
+    keys = GeneratePianoKeys(width, keyboardY, keyboardHeight);
+    keyIndexForMidi.fill(-1);
+    for (size_t i = 0; i < keys.size(); ++i) {
+        keyIndexForMidi[keys[i].midiNumber] = static_cast<int>(i);
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+// KeyboardLayout.h
+#pragma once
+
+#include <array>
+#include <vector>
+#include "raylib.h"
+#include "PianoKey.h"
+
+// Piano key geometry for the current window size. Keys are only regenerated
+// when the window size changes, and MIDI number lookups are constant time.
+class KeyboardLayout {
+public:
+    KeyboardLayout();
+
+    // Rebuilds the keys if the window size changed; returns true if it did
+    bool Update(int windowWidth, int windowHeight);
+
+    // White keys first, then black keys (draw order)
+    const std::vector<PianoKey>& GetKeys() const { return keys; }
+
+    // Returns the key for a MIDI number, or nullptr if it is not on the keyboard
+    const PianoKey* KeyForMidi(int midi) const {
+        if (midi < 0 || midi >= 128 || keyIndexForMidi[midi] < 0) return nullptr;
+        return &keys[keyIndexForMidi[midi]];
+    }
+
+    // Falling block color for a key and channel, darkened on black keys
+    Color BlockColor(int midi, int channel) const {
+        return blockColors[(channel & 0x0F) * 2 + (IsBlackMidiKey(midi) ? 1 : 0)];
+    }
+
+    int GetKeyboardY() const { return keyboardY; }
+    int GetKeyboardHeight() const { return keyboardHeight; }
+
+private:
+    int windowWidth = -1;
+    int windowHeight = -1;
+    int keyboardY = 0;
+    int keyboardHeight = 0;
+    std::vector<PianoKey> keys;
+    std::array<int, 128> keyIndexForMidi{};
+    std::array<Color, 32> blockColors{}; // [channel][isBlack]
+};
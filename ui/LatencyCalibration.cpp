@@ -0,0 +1,49 @@
+// LatencyCalibration.cpp
+#include "LatencyCalibration.h"
+
+#include <algorithm>
+#include <string>
+
+void LatencyCalibration::Start() {
+    active = true;
+    tapDelays.clear();
+    nextClick = Clock::now() + std::chrono::milliseconds(500);
+    lastClick = {};
+}
+
+void LatencyCalibration::Update(fluid_synth_t* synth) {
+    if (!active) return;
+    Clock::time_point now = Clock::now();
+    if (now < nextClick) return;
+    fluid_synth_noteoff(synth, CLICK_CHANNEL, CLICK_KEY);
+    fluid_synth_noteon(synth, CLICK_CHANNEL, CLICK_KEY, 120);
+    // Stamped when actually sent, which can be up to a frame after it was due
+    lastClick = now;
+    nextClick += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(CLICK_INTERVAL));
+}
+
+bool LatencyCalibration::Tap() {
+    if (!active || lastClick == Clock::time_point{}) return false;
+    double delay = std::chrono::duration<double>(Clock::now() - lastClick).count();
+    // A tap in the second half of the interval is early for the next click
+    if (delay > CLICK_INTERVAL / 2) delay -= CLICK_INTERVAL;
+    tapDelays.push_back(delay);
+    return static_cast<int>(tapDelays.size()) >= TAPS_NEEDED;
+}
+
+double LatencyCalibration::GetMeasuredLatency() const {
+    if (tapDelays.empty()) return 0.0;
+    std::vector<double> sorted = tapDelays;
+    std::sort(sorted.begin(), sorted.end());
+    return sorted[sorted.size() / 2];
+}
+
+void LatencyCalibration::Draw(Font font, int windowWidth, int y) const {
+    if (!active) return;
+    std::string text = "Latency test: tap SPACE on each click (" + std::to_string(tapDelays.size()) + "/" +
+                       std::to_string(TAPS_NEEDED) + "), L to cancel";
+    Vector2 size = MeasureTextEx(font, text.c_str(), 20, 1);
+    float x = (windowWidth - size.x) / 2;
+    DrawRectangleRec({x - 12, (float) y, size.x + 24, size.y + 16}, Color{0, 0, 0, 200});
+    DrawTextEx(font, text.c_str(), {x, (float) y + 8}, 20, 1, YELLOW);
+}
@@ -0,0 +1,40 @@
+// LatencyCalibration.h
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include <raylib.h>
+#include <fluidsynth.h>
+
+// Tap test: plays a steady click and measures how long after each click is sent
+// to the synth the user taps along with it. The median is the latency they hear.
+class LatencyCalibration {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void Start();
+    void Stop() { active = false; }
+    bool IsActive() const { return active; }
+
+    // Sends the next click when it is due; call once per frame
+    void Update(fluid_synth_t* synth);
+
+    // Records a tap; returns true once enough taps were collected
+    bool Tap();
+
+    // Median delay between a click being sent and the tap, in seconds
+    double GetMeasuredLatency() const;
+
+    void Draw(Font font, int windowWidth, int y) const;
+
+private:
+    static constexpr double CLICK_INTERVAL = 1.0;
+    static constexpr int TAPS_NEEDED = 8;
+    static constexpr int CLICK_CHANNEL = 9; // Percussion
+    static constexpr int CLICK_KEY = 76;    // Hi wood block
+
+    bool active = false;
+    Clock::time_point nextClick;
+    Clock::time_point lastClick;
+    std::vector<double> tapDelays;
+};
@@ -3,10 +3,14 @@
 //
 
 #include "MainMenuPage.h"
-#include "../utils/FileUtils.h"
+#include "ResourceCache.h"
+#include "PerfHud.h"
+#include "TextLayout.h"
 
 MainMenuPage::MainMenuPage(std::function<void()> onStart)
     : onStartCallback(std::move(onStart)) {
+    font = resourceCache.AcquireFont("Lexend.ttf");
+    logoTexture = resourceCache.AcquireTexture("assets/logo.png");
     float sidebarWidth = GetScreenWidth() * 0.24f;
     float sidebarHeight = GetScreenHeight();
     float btnX = 30;
@@ -20,16 +24,11 @@ MainMenuPage::MainMenuPage(std::function<void()> onStart)
     float textY = groupY + (std::max(textSize.y, logoHeight) - textSize.y) / 2;
     float startBtnY = textY + textSize.y + 0.05f * sidebarHeight;
     startBtn = {btnX, startBtnY, btnWidth, startBtnHeight};
-    font = LoadFontEx(GetResourcePath("Lexend.ttf").c_str(), 128, nullptr, 0);
-    SetTextureFilter(font.texture, TEXTURE_FILTER_BILINEAR);
-    Image logoImg = LoadImage(GetResourcePath("assets/logo.png").c_str());
-    logoTexture = LoadTextureFromImage(logoImg);
-    UnloadImage(logoImg);
 }
 
 MainMenuPage::~MainMenuPage() {
-    UnloadFont(font);
-    Texture2D logoTexture;
+    resourceCache.ReleaseFont("Lexend.ttf");
+    resourceCache.ReleaseTexture("assets/logo.png");
 }
 
 // Add this helper at the top of the file (or in an anonymous namespace)
@@ -60,20 +59,20 @@ void DrawSidebarButton(Rectangle btn, const char *text, Font font, float fontSiz
 
     DrawRectangleRounded(scaledBtn, 0.5f, 8, btnColor);
 
-    Vector2 textSize = MeasureTextEx(font, text, fontSize, 0);
-    DrawTextEx(
-        font,
-        text,
+    const TextLayout &label = textLayoutCache.Get(font, text, fontSize, 0);
+    Vector2 textSize = label.GetSize();
+    label.Draw(
         {
             scaledBtn.x + (scaledBtn.width - textSize.x) / 2,
             scaledBtn.y + (scaledBtn.height - textSize.y) / 2
         },
-        fontSize, 0, textColor
+        textColor
     );
 }
 
 // The "Start" button is now above the dummy buttons, "Settings" at the bottom
 void MainMenuPage::Draw() {
+    PerfHud::Clock::time_point uiStart = PerfHud::Clock::now();
     BeginDrawing();
     ClearBackground((Color){243, 243, 243, 255});
     float margin = 16.0f;
@@ -135,9 +134,9 @@ void MainMenuPage::Draw() {
     float logoWidth = 50.0f;
     float scale = logoWidth / logoTexture.width;
     float logoHeight = logoTexture.height * scale;
-    const char *logoText = "Sonique";
     float textFontSize = 30;
-    Vector2 textSize = MeasureTextEx(font, logoText, textFontSize, 0);
+    const TextLayout &logoText = textLayoutCache.Get(font, "Sonique", textFontSize, 0);
+    Vector2 textSize = logoText.GetSize();
     float spacing = 16.0f;
     float totalWidth = logoWidth + spacing + textSize.x;
     float groupX = sidebarX + sidebarWidth / 2 - totalWidth / 2;
@@ -145,7 +144,7 @@ void MainMenuPage::Draw() {
     float logoY = groupY + (std::max(textSize.y, logoHeight) - logoHeight) / 2;
     float textY = groupY + (std::max(textSize.y, logoHeight) - textSize.y) / 2;
     DrawTextureEx(logoTexture, {groupX, logoY}, 0, scale, WHITE);
-    DrawTextEx(font, logoText, {groupX + logoWidth + spacing, textY}, textFontSize, 0, (Color){70, 85, 83, 255});
+    logoText.Draw({groupX + logoWidth + spacing, textY}, (Color){70, 85, 83, 255});
 
     // "Start" button just below logo/text
     float btnX = sidebarX + 20;
@@ -205,11 +204,13 @@ void MainMenuPage::Draw() {
                       (Color){180, 200, 225, 255}, // pressed
                       (Color){40, 60, 90, 255});
     // Version text above the settings button
-    std::string versionText = "Version 0.1.0 Preview";
-    Vector2 versionSize = MeasureTextEx(font, versionText.c_str(), 20, 0);
+    const TextLayout &versionText = textLayoutCache.Get(font, "Version 0.1.0 Preview", 20, 0);
+    Vector2 versionSize = versionText.GetSize();
     float versionX = sidebarX + sidebarWidth / 2 - versionSize.x / 2;
     float versionY = settingsBtn.y - versionSize.y - 10;
-    DrawTextEx(font, versionText.c_str(), {versionX, versionY}, 20, 0, (Color){100, 100, 100, 255});
+    versionText.Draw({versionX, versionY}, (Color){100, 100, 100, 255});
+    perfHud.AddStageTime(PerfStage::Ui, PerfHud::Clock::now() - uiStart);
+    perfHud.Draw(margin + 10);
     EndDrawing();
 }
 
@@ -0,0 +1,221 @@
+// NoteRenderer.cpp
+#include "NoteRenderer.h"
+#include "rlgl.h"
+
+#include <array>
+#include <climits>
+#include <iostream>
+
+namespace {
+    // Matches the roundness DrawRectangleRounded used for the falling blocks
+    constexpr float BLOCK_ROUNDNESS = 0.4f;
+
+    constexpr int ATTRIB_CORNER = 0;
+    constexpr int ATTRIB_TIMING = 1;
+    constexpr int ATTRIB_COLOR = 2;
+
+    const char *noteVertexShader = R"(
+#version 330
+layout(location = 0) in vec2 vertexCorner;
+layout(location = 1) in vec4 noteTiming; // startTime, duration, key index, unused
+layout(location = 2) in vec4 noteColor;
+
+uniform float currentTime;
+uniform float fallSpeed;
+uniform float keyboardY;
+uniform vec2 screenSize;
+uniform vec2 keyColumns[88]; // x, width
+
+out vec2 localPos;
+out vec2 halfSize;
+out vec4 fragColor;
+
+void main() {
+    int keyIndex = int(noteTiming.z);
+    if (keyIndex < 0 || noteTiming.x + noteTiming.y < currentTime) {
+        // Not on the keyboard or already played: move the quad outside the clip volume
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        return;
+    }
+    vec2 column = keyColumns[keyIndex];
+    float height = noteTiming.y * fallSpeed;
+    float top = keyboardY - height + (currentTime - noteTiming.x) * fallSpeed;
+    vec2 size = vec2(column.y, height);
+    vec2 pos = vec2(column.x, top) + vertexCorner * size;
+
+    halfSize = size * 0.5;
+    localPos = (vertexCorner - 0.5) * size;
+    fragColor = noteColor;
+    gl_Position = vec4(pos.x / screenSize.x * 2.0 - 1.0, 1.0 - pos.y / screenSize.y * 2.0, 0.0, 1.0);
+}
+)";
+
+    const char *noteFragmentShader = R"(
+#version 330
+in vec2 localPos;
+in vec2 halfSize;
+in vec4 fragColor;
+
+uniform float roundness;
+
+out vec4 finalColor;
+
+void main() {
+    // Rounded box distance, with the corner radius DrawRectangleRounded would use
+    float radius = roundness * min(halfSize.x, halfSize.y);
+    vec2 q = abs(localPos) - halfSize + radius;
+    float dist = length(max(q, 0.0)) + min(max(q.x, q.y), 0.0) - radius;
+    float coverage = clamp(0.5 - dist, 0.0, 1.0);
+    finalColor = vec4(fragColor.rgb, fragColor.a * coverage);
+}
+)";
+}
+
+NoteRenderer::~NoteRenderer() {
+    Unload();
+}
+
+void NoteRenderer::Load() {
+    shader = LoadShaderFromMemory(noteVertexShader, noteFragmentShader);
+    if (shader.id == 0 || shader.id == rlGetShaderIdDefault()) {
+        std::cerr << "Note shader unavailable, drawing blocks on the CPU" << std::endl;
+        return;
+    }
+    currentTimeLoc = GetShaderLocation(shader, "currentTime");
+    fallSpeedLoc = GetShaderLocation(shader, "fallSpeed");
+    keyboardYLoc = GetShaderLocation(shader, "keyboardY");
+    screenSizeLoc = GetShaderLocation(shader, "screenSize");
+    keyColumnsLoc = GetShaderLocation(shader, "keyColumns");
+    roundnessLoc = GetShaderLocation(shader, "roundness");
+    float roundness = BLOCK_ROUNDNESS;
+    SetShaderValue(shader, roundnessLoc, &roundness, SHADER_UNIFORM_FLOAT);
+
+    // Two triangles covering the unit square, scaled per note in the shader
+    const float quad[12] = {0, 0, 0, 1, 1, 1, 0, 0, 1, 1, 1, 0};
+    vao = rlLoadVertexArray();
+    rlEnableVertexArray(vao);
+    quadVbo = rlLoadVertexBuffer(quad, sizeof(quad), false);
+    rlSetVertexAttribute(ATTRIB_CORNER, 2, RL_FLOAT, false, 0, 0);
+    rlEnableVertexAttribute(ATTRIB_CORNER);
+    rlDisableVertexArray();
+    ready = true;
+}
+
+void NoteRenderer::Unload() {
+    ReleaseBuffers();
+    if (quadVbo != 0) rlUnloadVertexBuffer(quadVbo);
+    if (vao != 0) rlUnloadVertexArray(vao);
+    if (ready) UnloadShader(shader);
+    quadVbo = vao = 0;
+    ready = false;
+}
+
+void NoteRenderer::ReleaseBuffers() {
+    for (const InstanceBuffer& buffer : buffers) {
+        if (buffer.vbo != 0) rlUnloadVertexBuffer(buffer.vbo);
+        if (buffer.longVbo != 0) rlUnloadVertexBuffer(buffer.longVbo);
+    }
+    buffers.clear();
+}
+
+void NoteRenderer::Upload(const MidiSong& song, const KeyboardLayout& layout) {
+    if (!ready) return;
+    ReleaseBuffers();
+    UploadBuffer(song.file.notes, song.noteIndex, layout);
+    for (const NoteLod::Level& level : song.lod.GetLevels()) UploadBuffer(level.runs, level.index, layout);
+
+    // Every buffer shares the attribute layout; Draw points it at the right one
+    rlEnableVertexArray(vao);
+    rlEnableVertexAttribute(ATTRIB_TIMING);
+    rlEnableVertexAttribute(ATTRIB_COLOR);
+    rlSetVertexAttributeDivisor(ATTRIB_TIMING, 1);
+    rlSetVertexAttributeDivisor(ATTRIB_COLOR, 1);
+    rlDisableVertexArray();
+}
+
+void NoteRenderer::UploadBuffer(const NoteStore& notes, const NoteIndex& index, const KeyboardLayout& layout) {
+    InstanceBuffer& buffer = buffers.emplace_back(InstanceBuffer{0, 0, 0, 0});
+    if (notes.Empty() || notes.Size() > INT_MAX / sizeof(NoteInstance)) return;
+
+    std::vector<NoteInstance> instances;
+    instances.reserve(notes.Size());
+    for (size_t i = 0; i < notes.Size(); ++i) {
+        int key = notes.Key(i);
+        bool onKeyboard = key >= FIRST_MIDI_KEY && key <= LAST_MIDI_KEY;
+        Color color = layout.BlockColor(key, notes.Channel(i));
+        instances.push_back({
+            notes.StartTime(i),
+            notes.Duration(i),
+            onKeyboard ? static_cast<float>(key - FIRST_MIDI_KEY) : -1.0f,
+            0.0f,
+            {color.r, color.g, color.b, color.a}
+        });
+    }
+    buffer.vbo = rlLoadVertexBuffer(instances.data(), static_cast<int>(instances.size() * sizeof(NoteInstance)), false);
+    buffer.count = instances.size();
+
+    const std::vector<size_t>& longNotes = index.GetLongNotes();
+    if (longNotes.empty()) return;
+    std::vector<NoteInstance> longInstances;
+    longInstances.reserve(longNotes.size());
+    for (size_t i : longNotes) longInstances.push_back(instances[i]);
+    buffer.longVbo = rlLoadVertexBuffer(longInstances.data(),
+                                        static_cast<int>(longInstances.size() * sizeof(NoteInstance)), false);
+    buffer.longCount = longInstances.size();
+}
+
+void NoteRenderer::SetKeyboard(const KeyboardLayout& layout) {
+    if (!ready) return;
+    std::array<float, NUM_TOTAL_KEYS * 2> columns{};
+    for (int midi = FIRST_MIDI_KEY; midi <= LAST_MIDI_KEY; ++midi) {
+        const PianoKey *key = layout.KeyForMidi(midi);
+        columns[(midi - FIRST_MIDI_KEY) * 2] = key->rect.x;
+        columns[(midi - FIRST_MIDI_KEY) * 2 + 1] = key->rect.width;
+    }
+    SetShaderValueV(shader, keyColumnsLoc, columns.data(), SHADER_UNIFORM_VEC2, NUM_TOTAL_KEYS);
+}
+
+void NoteRenderer::Draw(const NoteView& view, double currentTime, float fallSpeed, int keyboardY) {
+    size_t bufferIndex = static_cast<size_t>(view.level + 1);
+    if (!ready || bufferIndex >= buffers.size()) return;
+    const InstanceBuffer& buffer = buffers[bufferIndex];
+    NoteIndex::Range range = view.range;
+    bool drawMain = buffer.vbo != 0 && range.last <= buffer.count && range.last > range.first;
+    bool drawLong = buffer.longVbo != 0 && range.longLast <= buffer.longCount && range.longLast > range.longFirst;
+    if (!drawMain && !drawLong) return;
+
+    // Flush whatever raylib has batched so far, so the background stays below the blocks
+    rlDrawRenderBatchActive();
+
+    float time = static_cast<float>(currentTime);
+    float keyboardTop = static_cast<float>(keyboardY);
+    float screenSize[2] = {static_cast<float>(GetScreenWidth()), static_cast<float>(GetScreenHeight())};
+    SetShaderValue(shader, currentTimeLoc, &time, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, fallSpeedLoc, &fallSpeed, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, keyboardYLoc, &keyboardTop, SHADER_UNIFORM_FLOAT);
+    SetShaderValue(shader, screenSizeLoc, screenSize, SHADER_UNIFORM_VEC2);
+
+    rlEnableShader(shader.id);
+    rlEnableVertexArray(vao);
+    // Long blocks started earlier, so they go below the main range
+    if (drawLong) {
+        BindInstanceAttributes(buffer.longVbo, range.longFirst);
+        rlDrawVertexArrayInstanced(0, 6, static_cast<int>(range.longLast - range.longFirst));
+    }
+    if (drawMain) {
+        BindInstanceAttributes(buffer.vbo, range.first);
+        rlDrawVertexArrayInstanced(0, 6, static_cast<int>(range.last - range.first));
+    }
+    rlDisableVertexArray();
+    rlDisableShader();
+}
+
+void NoteRenderer::BindInstanceAttributes(unsigned int vbo, size_t firstInstance) const {
+    // The instance range is selected by offsetting the attribute pointers
+    int stride = sizeof(NoteInstance);
+    int offset = static_cast<int>(firstInstance * sizeof(NoteInstance));
+    rlEnableVertexBuffer(vbo);
+    rlSetVertexAttribute(ATTRIB_TIMING, 4, RL_FLOAT, false, stride, offset);
+    rlSetVertexAttribute(ATTRIB_COLOR, 4, RL_UNSIGNED_BYTE, true, stride, offset + 4 * sizeof(float));
+    rlDisableVertexBuffer();
+}
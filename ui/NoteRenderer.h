@@ -0,0 +1,68 @@
+// NoteRenderer.h
+#pragma once
+
+#include <vector>
+#include "raylib.h"
+#include "KeyboardLayout.h"
+#include "../MidiLogic/MidiSong.h"
+
+// Draws falling blocks from static per-song instance buffers, one for the raw
+// notes and one for each LOD level. Block placement
+// and the rounded corners are computed in the shader from the current time, so
+// a frame is a single instanced draw call whatever the note count, plus one
+// for long blocks that started before the visible range.
+class NoteRenderer {
+public:
+    NoteRenderer() = default;
+    NoteRenderer(const NoteRenderer&) = delete;
+    NoteRenderer& operator=(const NoteRenderer&) = delete;
+    ~NoteRenderer();
+
+    // Compiles the shader and creates the quad geometry. Needs an open window.
+    void Load();
+    void Unload();
+
+    // False if the shader could not be compiled; callers then draw on the CPU
+    bool IsReady() const { return ready; }
+
+    // Uploads every note and LOD run of the current song, in store order
+    void Upload(const MidiSong& song, const KeyboardLayout& layout);
+
+    // Must be called whenever the keyboard layout was rebuilt
+    void SetKeyboard(const KeyboardLayout& layout);
+
+    // view must come from SelectNotes on the uploaded song
+    void Draw(const NoteView& view, double currentTime, float fallSpeed, int keyboardY);
+
+private:
+    struct NoteInstance {
+        float startTime;
+        float duration;
+        float keyIndex; // MIDI number - 21, negative if not on the keyboard
+        float padding;
+        unsigned char color[4];
+    };
+
+    bool ready = false;
+    Shader shader{};
+    unsigned int vao = 0;
+    unsigned int quadVbo = 0;
+    struct InstanceBuffer {
+        unsigned int vbo;
+        size_t count;
+        unsigned int longVbo; // The index's long blocks, in long list order
+        size_t longCount;
+    };
+    std::vector<InstanceBuffer> buffers; // Raw notes, then each LOD level
+
+    int currentTimeLoc = -1;
+    int fallSpeedLoc = -1;
+    int keyboardYLoc = -1;
+    int screenSizeLoc = -1;
+    int keyColumnsLoc = -1;
+    int roundnessLoc = -1;
+
+    void ReleaseBuffers();
+    void UploadBuffer(const NoteStore& notes, const NoteIndex& index, const KeyboardLayout& layout);
+    void BindInstanceAttributes(unsigned int vbo, size_t firstInstance) const;
+};
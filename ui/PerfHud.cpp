@@ -0,0 +1,110 @@
+// PerfHud.cpp
+#include "PerfHud.h"
+#include "raylib.h"
+#include "ResourceCache.h"
+
+#include <algorithm>
+#include <cstdio>
+
+PerfHud perfHud;
+
+namespace {
+    float ToMs(PerfHud::Clock::duration time) {
+        return std::chrono::duration<float, std::milli>(time).count();
+    }
+
+    std::string Format(const char* format, double a, double b = 0.0, double c = 0.0, double d = 0.0) {
+        char buffer[96];
+        std::snprintf(buffer, sizeof(buffer), format, a, b, c, d);
+        return buffer;
+    }
+
+    const char* stageNames[] = {"update", "blocks", "keys", "ui"};
+}
+
+void PerfHud::BeginFrame() {
+    Clock::time_point now = Clock::now();
+    if (frameStart != Clock::time_point{}) {
+        frameMs[historyNext] = ToMs(now - frameStart);
+        for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+            stageMs[stage][historyNext] = ToMs(currentStages[stage]);
+        }
+        drawCalls[historyNext] = currentDrawCalls;
+        historyNext = (historyNext + 1) % HISTORY;
+        historyCount = std::min(historyCount + 1, HISTORY);
+    }
+    frameStart = now;
+    currentStages.fill(Clock::duration::zero());
+    currentDrawCalls = 0;
+}
+
+void PerfHud::BuildLines() {
+    lines.clear();
+    if (historyCount == 0) return;
+
+    std::array<float, HISTORY> sorted = frameMs;
+    std::sort(sorted.begin(), sorted.begin() + historyCount);
+    auto percentile = [&](double p) { return sorted[static_cast<size_t>(p * (historyCount - 1))]; };
+    double total = 0.0;
+    for (size_t i = 0; i < historyCount; ++i) total += sorted[i];
+    double average = total / historyCount;
+
+    lines.push_back(Format("frame %.2f ms (%.0f fps)", average, average > 0.0 ? 1000.0 / average : 0.0));
+    lines.push_back(Format("p50 %.2f  p95 %.2f  p99 %.2f  max %.2f",
+                           percentile(0.50), percentile(0.95), percentile(0.99), sorted[historyCount - 1]));
+    for (int stage = 0; stage < STAGE_COUNT; ++stage) {
+        double stageTotal = 0.0;
+        float stageMax = 0.0f;
+        for (size_t i = 0; i < historyCount; ++i) {
+            stageTotal += stageMs[stage][i];
+            stageMax = std::max(stageMax, stageMs[stage][i]);
+        }
+        lines.push_back(std::string(stageNames[stage]) + Format("  %.2f ms (max %.2f)", stageTotal / historyCount, stageMax));
+    }
+
+    double callTotal = 0.0;
+    for (size_t i = 0; i < historyCount; ++i) callTotal += drawCalls[i];
+    lines.push_back(Format("draw cmds %.0f", callTotal / historyCount));
+    lines.push_back(Format("blocks %.0f / %.0f", static_cast<double>(visibleBlocks), static_cast<double>(totalBlocks)));
+    if (synth != nullptr) {
+        lines.push_back(Format("synth cpu %.1f%%  voices %.0f", fluid_synth_get_cpu_load(synth),
+                               static_cast<double>(fluid_synth_get_active_voice_count(synth))));
+    }
+    if (synthTuner != nullptr) {
+        const SynthProfile& profile = synthTuner->GetCurrent();
+        lines.push_back(Format("synth level %.0f/%.0f  poly %.0f  late buffers %.0f",
+                               static_cast<double>(synthTuner->GetLevel()),
+                               static_cast<double>(synthTuner->GetLevelCount() - 1),
+                               static_cast<double>(profile.polyphony),
+                               static_cast<double>(synthTuner->GetLateBuffers())));
+    }
+    size_t gpuBytes = 0;
+    std::vector<ResourceCache::AssetMemory> assets = resourceCache.GetMemoryReport();
+    for (const auto& asset : assets) gpuBytes += asset.bytes;
+    lines.push_back(Format("gpu assets %.1f MB", gpuBytes / (1024.0 * 1024.0)));
+    for (const auto& asset : assets) {
+        lines.push_back("  " + asset.name + Format("  %.0f KB x%.0f", asset.bytes / 1024.0, asset.references));
+    }
+    if (inputLatency != nullptr && inputLatency->GetCount() > 0) {
+        lines.push_back(Format("midi in p50 %.1f  p99 %.1f ms (%.0f notes)", inputLatency->Percentile(0.50),
+                               inputLatency->Percentile(0.99), static_cast<double>(inputLatency->GetCount())));
+    }
+}
+
+void PerfHud::Draw(int topY) {
+    if (!visible) return;
+    Clock::time_point now = Clock::now();
+    if (now - linesBuilt > std::chrono::milliseconds(250)) {
+        BuildLines();
+        linesBuilt = now;
+    }
+
+    const int fontSize = 10;
+    const int lineHeight = 14;
+    const int width = 250;
+    int x = GetScreenWidth() - width - 10;
+    DrawRectangle(x, topY, width, static_cast<int>(lines.size()) * lineHeight + 10, Color{0, 0, 0, 180});
+    for (size_t i = 0; i < lines.size(); ++i) {
+        DrawText(lines[i].c_str(), x + 8, topY + 5 + static_cast<int>(i) * lineHeight, fontSize, GREEN);
+    }
+}
@@ -0,0 +1,83 @@
+// PerfHud.h
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fluidsynth.h>
+#include "../utils/LatencyHistogram.h"
+#include "../utils/SynthTuner.h"
+
+// Parts of a frame timed separately by the HUD
+enum class PerfStage { Update, Blocks, Keys, Ui, Count };
+
+// Overlay with rolling frame statistics, toggled with F3. Collection is always
+// on and costs two clock reads per timed stage; the statistics are only
+// computed while the overlay is visible.
+class PerfHud {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    void AttachSynth(fluid_synth_t* synth) { this->synth = synth; }
+    void AttachInputLatency(const LatencyHistogram* histogram) { inputLatency = histogram; }
+    void AttachSynthTuner(const SynthTuner* tuner) { synthTuner = tuner; }
+
+    // Call once per frame, before any stage is timed
+    void BeginFrame();
+    // The loop iteration since BeginFrame() did not draw; it is left out of the history
+    void DiscardFrame() { frameStart = Clock::time_point{}; }
+
+    void AddStageTime(PerfStage stage, Clock::duration time) { currentStages[static_cast<int>(stage)] += time; }
+    void CountDrawCalls(size_t count) { currentDrawCalls += count; }
+    void SetBlockCounts(size_t visible, size_t total) { visibleBlocks = visible; totalBlocks = total; }
+
+    void Toggle() { visible = !visible; }
+    bool IsVisible() const { return visible; }
+
+    // Draws the overlay in the top right corner; call inside BeginDrawing()
+    void Draw(int topY);
+
+private:
+    static constexpr size_t HISTORY = 240;
+    static constexpr int STAGE_COUNT = static_cast<int>(PerfStage::Count);
+
+    bool visible = false;
+    fluid_synth_t* synth = nullptr;
+    const LatencyHistogram* inputLatency = nullptr;
+    const SynthTuner* synthTuner = nullptr;
+
+    Clock::time_point frameStart{};
+    std::array<Clock::duration, STAGE_COUNT> currentStages{};
+    size_t currentDrawCalls = 0;
+    size_t visibleBlocks = 0;
+    size_t totalBlocks = 0;
+
+    // Ring buffers of finished frames, in milliseconds
+    std::array<float, HISTORY> frameMs{};
+    std::array<std::array<float, HISTORY>, STAGE_COUNT> stageMs{};
+    std::array<size_t, HISTORY> drawCalls{};
+    size_t historyCount = 0;
+    size_t historyNext = 0;
+
+    // Text is rebuilt a few times per second rather than every frame
+    std::vector<std::string> lines;
+    Clock::time_point linesBuilt{};
+
+    void BuildLines();
+};
+
+extern PerfHud perfHud;
+
+// Adds the lifetime of the scope to a stage of the current frame
+class ScopedTimer {
+public:
+    explicit ScopedTimer(PerfStage stage) : stage(stage), start(PerfHud::Clock::now()) {}
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+    ~ScopedTimer() { perfHud.AddStageTime(stage, PerfHud::Clock::now() - start); }
+
+private:
+    PerfStage stage;
+    PerfHud::Clock::time_point start;
+};
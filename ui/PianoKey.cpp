@@ -3,74 +3,62 @@
 //
 
 #include "PianoKey.h"
+#include "KeyboardLayout.h"
+#include "TextLayout.h"
 
 
 std::vector<PianoKey> GeneratePianoKeys(int windowWidth, int keyboardY, int keyboardHeight) {
     std::vector<PianoKey> keys;
+    keys.reserve(NUM_TOTAL_KEYS);
     float whiteKeyWidth = static_cast<float>(windowWidth) / NUM_WHITE_KEYS;
     float blackKeyWidth = whiteKeyWidth * 0.6f;
     float blackKeyHeight = keyboardHeight * 0.65f;
 
-    // Generate all keys from MIDI 21 (A0) to 108 (C8)
-    int whiteIndex = 0;
-    for (int midi = 21; midi <= 108; ++midi) {
-        int noteInOctave = midi % 12;
-        int octave = (midi / 12) - 1;
-        std::string label = noteNames[noteInOctave] + std::to_string(octave);
-
-        // White keys: C, D, E, F, G, A, B
-        if (noteNames[noteInOctave].length() == 1) {
-            keys.push_back({
-                Rectangle{
-                    whiteIndex * whiteKeyWidth, static_cast<float>(keyboardY + 2), whiteKeyWidth,
-                    static_cast<float>(keyboardHeight)
-                },
-                false,
-                midi,
-                label
-            });
-            ++whiteIndex;
-        }
+    // White keys: C, D, E, F, G, A, B from MIDI 21 (A0) to 108 (C8)
+    for (int midi = FIRST_MIDI_KEY; midi <= LAST_MIDI_KEY; ++midi) {
+        if (IsBlackMidiKey(midi)) continue;
+        keys.push_back({
+            Rectangle{
+                whiteIndexTable[midi] * whiteKeyWidth, static_cast<float>(keyboardY + 2), whiteKeyWidth,
+                static_cast<float>(keyboardHeight)
+            },
+            false,
+            midi,
+            noteNames[midi % 12] + std::to_string(midi / 12 - 1)
+        });
     }
 
-    // Black keys
-    whiteIndex = 0;
-    for (int midi = 22; midi <= 108; ++midi) {
-        int noteInOctave = midi % 12;
-        int octave = (midi / 12) - 1;
-        std::string label = noteNames[noteInOctave] + std::to_string(octave);
-
-        // Black keys: C#, D#, F#, G#, A#
-        if (noteNames[noteInOctave].length() == 2) {
-            // Position black key between the two adjacent white keys
-            float x = (whiteIndex + 1) * whiteKeyWidth - blackKeyWidth / 2;
-            keys.push_back({
-                Rectangle{x, static_cast<float>(keyboardY), blackKeyWidth, blackKeyHeight},
-                true,
-                midi,
-                label
-            });
-        }
-        // Only increment whiteIndex after a white key
-        if (noteNames[noteInOctave].length() == 1) {
-            ++whiteIndex;
-        }
+    // Black keys: C#, D#, F#, G#, A#, centered on the edge of the white key below them
+    for (int midi = FIRST_MIDI_KEY; midi <= LAST_MIDI_KEY; ++midi) {
+        if (!IsBlackMidiKey(midi)) continue;
+        float x = whiteIndexTable[midi] * whiteKeyWidth - blackKeyWidth / 2;
+        keys.push_back({
+            Rectangle{x, static_cast<float>(keyboardY), blackKeyWidth, blackKeyHeight},
+            true,
+            midi,
+            noteNames[midi % 12] + std::to_string(midi / 12 - 1)
+        });
     }
     return keys;
 }
 
 void DrawPianoKeys(
-    const std::vector<PianoKey> &keys,
+    const KeyboardLayout &layout,
     std::vector<bool> &keyWasPressed,
     fluid_synth_t *synth,
     Font font,
     bool showKeyLabels,
-    Texture2D whiteKey,
-    Texture2D whiteKeyPressed,
-    Texture2D blackKey,
-    Texture2D blackKeyPressed,
-    const std::vector<std::vector<bool> > &midiKeyStates // <-- add this
+    const TextureAtlas &atlas,
+    const KeyStates::Snapshot &pressedKeys
 ) {
+    const std::vector<PianoKey> &keys = layout.GetKeys();
+
+    // Key sprites and the rectangles between them all come from the atlas, so
+    // the whole keyboard is one batch; labels use the font texture and follow after
+    Texture2D previousShapesTexture = GetShapesTexture();
+    Rectangle previousShapesRegion = GetShapesTextureRectangle();
+    SetShapesTexture(atlas.texture, atlas.whiteRegion);
+
     // First, check if any black key is pressed at the mouse position
 
     Vector2 mousePos = GetMousePosition();
@@ -103,33 +91,14 @@ void DrawPianoKeys(
                 fluid_synth_noteoff(synth, 0, key.midiNumber);
             }
             keyWasPressed[i] = pressed;
-            for (int ch = 0; ch < 16; ++ch) {
-                if (midiKeyStates[ch][key.midiNumber - 21]) {
-                    midiPressed = true;
-                    break;
-                }
-            }
-            Texture2D tex = pressed || midiPressed ? whiteKeyPressed : whiteKey;
-            if (tex.id != 0) {
-                DrawTexturePro(
-                    tex,
-                    Rectangle{0, 0, (float) tex.width, (float) tex.height},
-                    key.rect,
-                    Vector2{0, 0},
-                    0.0f,
-                    WHITE
-                );
+            midiPressed = pressedKeys.IsDown(key.midiNumber - FIRST_MIDI_KEY);
+            Rectangle source = atlas.Region(pressed || midiPressed ? SPRITE_WHITE_KEY_PRESSED : SPRITE_WHITE_KEY);
+            if (source.width > 0) {
+                DrawTexturePro(atlas.texture, source, key.rect, Vector2{0, 0}, 0.0f, WHITE);
             } else {
                 DrawRectangleRec(key.rect, pressed ? LIGHTGRAY : RAYWHITE);
             }
             DrawRectangleLinesEx(key.rect, 1, GRAY);
-
-            if (showKeyLabels && key.label[0] == 'C') {
-                Vector2 textSize = MeasureTextEx(font, key.label.c_str(), 12, 1);
-                DrawTextEx(font, key.label.c_str(),
-                           {key.rect.x + key.rect.width / 2 - textSize.x / 2, key.rect.y + key.rect.height - 18},
-                           12, 1, DARKGRAY);
-            }
         }
     }
     // Draw black keys on top (unchanged)
@@ -147,12 +116,7 @@ void DrawPianoKeys(
                 fluid_synth_noteoff(synth, 0, key.midiNumber);
             }
             keyWasPressed[i] = pressed;
-            for (int ch = 0; ch < 16; ++ch) {
-                if (midiKeyStates[ch][key.midiNumber - 21]) {
-                    midiPressed = true;
-                    break;
-                }
-            }
+            midiPressed = pressedKeys.IsDown(key.midiNumber - FIRST_MIDI_KEY);
             // Draw a border (gap) behind the black key: thin sides/top, thick bottom
             float sideBorder = 1.5f;
             float topBorder = 1.0f;
@@ -165,25 +129,23 @@ void DrawPianoKeys(
             };
             DrawRectangleRec(borderRect, BLACK);
 
-            Texture2D tex = pressed || midiPressed ? blackKeyPressed : blackKey;
-            if (tex.id != 0) {
-                DrawTexturePro(
-                    tex,
-                    Rectangle{0, 0, (float) tex.width, (float) tex.height},
-                    key.rect,
-                    Vector2{0, 0},
-                    0.0f,
-                    WHITE
-                );
+            Rectangle source = atlas.Region(pressed || midiPressed ? SPRITE_BLACK_KEY_PRESSED : SPRITE_BLACK_KEY);
+            if (source.width > 0) {
+                DrawTexturePro(atlas.texture, source, key.rect, Vector2{0, 0}, 0.0f, WHITE);
             } else {
                 DrawRectangleRec(key.rect, pressed ? GRAY : BLACK);
             }
-            if (false) {
-                Vector2 textSize = MeasureTextEx(font, key.label.c_str(), 10, 1);
-                DrawTextEx(font, key.label.c_str(),
-                           {key.rect.x + key.rect.width / 2 - textSize.x / 2, key.rect.y + key.rect.height - 16},
-                           10, 1, RAYWHITE);
-            }
+        }
+    }
+    SetShapesTexture(previousShapesTexture, previousShapesRegion);
+
+    // Labels on the C keys, below where the black keys reach
+    if (showKeyLabels) {
+        for (const auto &key: keys) {
+            if (key.isBlack || key.label[0] != 'C') continue;
+            const TextLayout &text = textLayoutCache.Get(font, key.label, 12);
+            text.Draw({key.rect.x + key.rect.width / 2 - text.GetSize().x / 2, key.rect.y + key.rect.height - 18},
+                      DARKGRAY);
         }
     }
 }
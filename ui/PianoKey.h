@@ -1,21 +1,41 @@
 #pragma once
+#include <array>
 #include <string>
 #include <vector>
 #include <fluidsynth.h>
 #include "raylib.h"
+#include "../MidiLogic/KeyStates.h"
+#include "TextureAtlas.h"
 
 constexpr int NUM_WHITE_KEYS = 52;
 constexpr int NUM_BLACK_KEYS = 36;
 constexpr int NUM_TOTAL_KEYS = 88;
 constexpr float KEYBOARD_ASPECT = 10.0f; // width:height ratio
 
-const std::array<std::string, 12> noteNames = {
+constexpr int FIRST_MIDI_KEY = 21; // A0
+constexpr int LAST_MIDI_KEY = 108;  // C8
+
+constexpr std::array<const char *, 12> noteNames = {
     "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B"
 };
 
-const std::array<std::string, 7> whiteKeyNames = {"A", "B", "C", "D", "E", "F", "G"};
-const std::array<int, 7> blackKeyPattern = {1, 0, 1, 1, 1, 0, 1}; // A#, C#, D#, F#, G#
-const std::array<std::string, 5> blackKeyNames = {"A#", "C#", "D#", "F#", "G#"};
+// Indexed by MIDI number % 12, starting at C
+constexpr std::array<bool, 12> isBlackNote = {
+    false, true, false, true, false, false, true, false, true, false, true, false
+};
+
+constexpr bool IsBlackMidiKey(int midi) { return isBlackNote[midi % 12]; }
+
+// Number of white keys below each MIDI number on the 88-key keyboard
+constexpr std::array<int, 128> whiteIndexTable = [] {
+    std::array<int, 128> table{};
+    int whiteIndex = 0;
+    for (int midi = 0; midi < 128; ++midi) {
+        table[midi] = whiteIndex;
+        if (midi >= FIRST_MIDI_KEY && midi <= LAST_MIDI_KEY && !IsBlackMidiKey(midi)) ++whiteIndex;
+    }
+    return table;
+}();
 
 struct PianoKey {
     Rectangle rect;
@@ -24,19 +44,29 @@ struct PianoKey {
     std::string label;
 };
 
+class KeyboardLayout;
+
+// Sprites of PianoPage's "ui" atlas, indexing TextureAtlas::regions
+enum UiSprite : size_t {
+    SPRITE_WHITE_KEY,
+    SPRITE_WHITE_KEY_PRESSED,
+    SPRITE_BLACK_KEY,
+    SPRITE_BLACK_KEY_PRESSED,
+    SPRITE_PLAY,
+    SPRITE_PAUSE,
+    SPRITE_COUNT
+};
+
 std::vector<PianoKey> GeneratePianoKeys(int windowWidth, int keyboardY, int keyboardHeight);
 
 void DrawPianoKeys(
-    const std::vector<PianoKey>& keys,
+    const KeyboardLayout& layout,
     std::vector<bool>& keyWasPressed,
     fluid_synth_t* synth,
     Font font,
     bool showKeyLabels,
-    Texture2D whiteKey,
-    Texture2D whiteKeyPressed,
-    Texture2D blackKey,
-    Texture2D blackKeyPressed,
-    const std::vector<std::vector<bool>>& midiKeyStates
+    const TextureAtlas& atlas,
+    const KeyStates::Snapshot& pressedKeys
 );
 
 void ResetKeyPressedStates(std::vector<bool>& keyWasPressed);
\ No newline at end of file
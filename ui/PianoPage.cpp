@@ -1,36 +1,61 @@
 #include "PianoPage.h"
 #include "../utils/MidiUtils.h"
-#include "../utils/FileUtils.h"
-
+#include "../MidiLogic/NoteIndex.h"
+#include "../MidiLogic/TempoMap.h"
+#include "PerfHud.h"
+#include "ResourceCache.h"
+#include "TextLayout.h"
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
 #include <iostream>
 
-extern std::vector<MidiBlock> midiBlocks;
-extern int ticksPerQuarter;
 
 PianoPage::PianoPage(
     fluid_synth_t *synth,
-    fluid_player_t *player,
+    PlayerManager &players,
     std::vector<std::string> &loadedMidiFiles,
     std::vector<SongInfo> &loadedSongInfos,
     std::vector<int> &midiBpms,
-    std::vector<std::vector<bool> > &midiKeyStates
+    KeyStates &midiKeyStates,
+    KeyStates &liveKeyStates,
+    KeyEventQueue &midiKeyEvents,
+    AudioConfig &audioConfig,
+    PlaybackClock &playbackClock,
+    SoundFontManager &soundFonts
 )
     : synth(synth),
-      player(player),
+      players(players),
       loadedMidiFiles(loadedMidiFiles),
       loadedSongInfos(loadedSongInfos),
       midiBpms(midiBpms),
-      midiKeyStates(midiKeyStates) {
+      midiKeyStates(midiKeyStates),
+      liveKeyStates(liveKeyStates),
+      midiKeyEvents(midiKeyEvents),
+      audioConfig(audioConfig),
+      playbackClock(playbackClock),
+      soundFonts(soundFonts),
+      songBrowser(loadedSongInfos),
+      songLoader(loadedMidiFiles) {
     tempo = midiBpms.empty() ? 120 : midiBpms[0];
     currentSongIndex = -1;
     amountOfSongs = static_cast<int>(loadedMidiFiles.size());
-    dropdownOpen = false;
     isPlaying = false;
     dropdownX = 20;
     dropdownY = 10;
     dropdownWidth = 260;
     dropdownHeight = 30;
     dropdownBox = {dropdownX, dropdownY, dropdownWidth, dropdownHeight};
+    for (int ch = 0; ch < 16; ++ch) {
+        channelLabels[ch] = "Channel " + std::to_string(ch + 1);
+        mutedChannelLabels[ch] = channelLabels[ch] + " (Muted)";
+    }
+    for (const std::string &path: soundFonts.GetSoundFonts()) {
+        soundFontLabels.push_back(std::filesystem::path(path).stem().string());
+    }
     LoadResources();
     ReloadSong(1);
 }
@@ -40,37 +65,37 @@ PianoPage::~PianoPage() {
 }
 
 void PianoPage::LoadResources() {
-    font = LoadFont(GetResourcePath("Lexend.ttf").c_str());
-    background = LoadTexture(GetResourcePath("assets/background2.png").c_str());
-    whiteKey = LoadTexture(GetResourcePath("assets/whiteKey.png").c_str());
-    whiteKeyPressed = LoadTexture(GetResourcePath("assets/whiteKeyPressed.png").c_str());
-    blackKey = LoadTexture(GetResourcePath("assets/black-key-raised.png").c_str());
-    blackKeyPressed = LoadTexture(GetResourcePath("assets/black-key-pressed.png").c_str());
-    playIcon = LoadTexture(GetResourcePath("assets/play.png").c_str());
-    pauseIcon = LoadTexture(GetResourcePath("assets/pause.png").c_str());
+    font = resourceCache.AcquireFont("Lexend.ttf");
+    background = resourceCache.AcquireTexture("assets/background2.png");
+    std::vector<std::string> sprites(SPRITE_COUNT);
+    sprites[SPRITE_WHITE_KEY] = "assets/whiteKey.png";
+    sprites[SPRITE_WHITE_KEY_PRESSED] = "assets/whiteKeyPressed.png";
+    sprites[SPRITE_BLACK_KEY] = "assets/black-key-raised.png";
+    sprites[SPRITE_BLACK_KEY_PRESSED] = "assets/black-key-pressed.png";
+    sprites[SPRITE_PLAY] = "assets/play.png";
+    sprites[SPRITE_PAUSE] = "assets/pause.png";
+    atlas = &resourceCache.AcquireAtlas("ui", sprites);
+    noteRenderer.Load();
 }
 
 void PianoPage::UnloadResources() {
-    UnloadTexture(playIcon);
-    UnloadTexture(pauseIcon);
-    UnloadTexture(whiteKey);
-    UnloadTexture(whiteKeyPressed);
-    UnloadTexture(blackKey);
-    UnloadTexture(blackKeyPressed);
-    UnloadFont(font);
-    UnloadTexture(background);
+    resourceCache.ReleaseAtlas("ui");
+    resourceCache.ReleaseFont("Lexend.ttf");
+    resourceCache.ReleaseTexture("assets/background2.png");
+    noteRenderer.Unload();
 }
 
 void PianoPage::Draw() {
     int windowWidth = GetScreenWidth();
     int windowHeight = GetScreenHeight();
 
-    int keyboardHeight = static_cast<int>(windowWidth / KEYBOARD_ASPECT);
-    if (keyboardHeight > windowHeight) keyboardHeight = windowHeight;
-    int keyboardY = windowHeight - keyboardHeight;
-
-    keys = GeneratePianoKeys(windowWidth, keyboardY, keyboardHeight);
-    if (keyWasPressed.size() != keys.size()) keyWasPressed.assign(keys.size(), false);
+    if (keyboardLayout.Update(windowWidth, windowHeight)) {
+        noteRenderer.SetKeyboard(keyboardLayout);
+    }
+    int keyboardY = keyboardLayout.GetKeyboardY();
+    if (keyWasPressed.size() != keyboardLayout.GetKeys().size()) {
+        keyWasPressed.assign(keyboardLayout.GetKeys().size(), false);
+    }
 
     BeginDrawing();
 
@@ -84,56 +109,46 @@ void PianoPage::Draw() {
     );
 
     // Draw falling MIDI blocks
-   double currentTime = (static_cast<double>(fluid_player_get_current_tick(player)) / static_cast<double>(ticksPerQuarter)) * (60.0 / tempo);
-
-    for (const auto &block: midiBlocks) {
-        int keyIdx = -1;
-        for (int i = 0; i < keys.size(); ++i) {
-            if (keys[i].midiNumber == block.key) {
-                keyIdx = i;
-                break;
+    // Block times are in song seconds, so the tempo multiplier only changes how fast the tick advances
+    // Until the first parse is published there is nothing to draw and the clock stays at zero
+    static const TempoMap noTempoMap;
+    const TempoMap &tempoMap = song ? song->file.tempoMap : noTempoMap;
+    // The clock is what the synth rendered; the speakers are behind it by the output
+    // latency, which is real time and covers more of the song when it is sped up
+    double currentTime = playbackClock.Update(player, tempoMap, isPlaying) -
+                         OutputLatencySeconds(audioConfig) * TempoRatio();
+    songTime = currentTime;
+
+    // Only blocks between the keyboard line and the top of the window are visible
+    double visibleSeconds = static_cast<double>(keyboardY) / fallSpeed;
+    // Dense windows draw merged runs from a LOD level instead of every note
+    NoteView visible{nullptr, nullptr, {0, 0}, -1};
+    if (song) visible = SelectNotes(*song, currentTime, currentTime + visibleSeconds, fallSpeed);
+    perfHud.SetBlockCounts(visible.range.Size(), song ? song->file.notes.Size() : 0);
+    {
+        ScopedTimer timer(PerfStage::Blocks);
+        if (noteRenderer.IsReady()) {
+            noteRenderer.Draw(visible, currentTime, fallSpeed, keyboardY);
+            const NoteIndex::Range &range = visible.range;
+            perfHud.CountDrawCalls((range.last > range.first ? 1 : 0) + (range.longLast > range.longFirst ? 1 : 0));
+        } else if (song) {
+            PrepareBlockFrame(*song, keyboardLayout, currentTime, fallSpeed, keyboardY, blockQuads);
+            for (const BlockQuad &quad: blockQuads) {
+                DrawRectangleRounded(quad.rect, 0.4f, 8, quad.color);
             }
+            perfHud.CountDrawCalls(blockQuads.size());
         }
-        if (keyIdx < 0) continue;
-        if (keyIdx < 0 || keyIdx >= keys.size()) continue;
-
-        float blockX = keys[keyIdx].rect.x;
-        float blockWidth = keys[keyIdx].rect.width;
-        float blockY = block.getY(keyboardY, fallSpeed, currentTime);
-        float blockHeight = block.getHeight(fallSpeed);
-
-        // C++
-        // Assume keyIdx is valid and keys[keyIdx].isBlack exists
-        float r = block.color.r;
-        float g = block.color.g;
-        float b = block.color.b;
-        if (keys[keyIdx].isBlack) {
-            r *= 0.6f;
-            g *= 0.6f;
-            b *= 0.6f;
-        }
-        DrawRectangleRounded(
-            Rectangle{blockX, blockY, blockWidth, blockHeight},
-            0.4f,
-            8,
-            Color{
-                static_cast<unsigned char>(r * 255),
-                static_cast<unsigned char>(g * 255),
-                static_cast<unsigned char>(b * 255),
-                static_cast<unsigned char>(block.color.a * 255)
-            }
-        );
     }
 
     // Toolbar
+    PerfHud::Clock::time_point uiStart = PerfHud::Clock::now();
     DrawRectangle(0, 0, windowWidth, 50, BLACK);
     DrawLineEx({0, 50}, {(float) windowWidth, 50}, 1.0f, DARKGRAY);
 
     // Tempo box
     DrawRectangleRec({dropdownX + 290, dropdownY, 90, 30}, DARKGRAY);
-    std::string tempoStr = std::to_string(tempo);
-    Vector2 tempoTextSize = MeasureTextEx(font, tempoStr.c_str(), 16, 1);
-    DrawTextEx(font, tempoStr.c_str(), {dropdownX + 340 - tempoTextSize.x / 2, dropdownY + 6}, 16, 1, YELLOW);
+    const TextLayout& tempoText = tempoLabel.Get(font, tempo, 16);
+    tempoText.Draw({dropdownX + 340 - tempoText.GetSize().x / 2, dropdownY + 6}, YELLOW);
 
     // Up/Down arrows
     Rectangle upBtn = {dropdownX + 352, dropdownY + 2, 24, 12};
@@ -156,10 +171,8 @@ void PianoPage::Draw() {
     // Fall Speed box (placed next to Tempo box)
     float fallSpeedBoxX = dropdownX + 390.0f; // adjust as needed for spacing
     DrawRectangleRec({fallSpeedBoxX, dropdownY, 90.0f, 30.0f}, DARKGRAY);
-    std::string fallSpeedStr = std::to_string(static_cast<int>(fallSpeed));
-    Vector2 fallSpeedTextSize = MeasureTextEx(font, fallSpeedStr.c_str(), 16, 1);
-    DrawTextEx(font, fallSpeedStr.c_str(), {fallSpeedBoxX + 45.0f - fallSpeedTextSize.x / 2, dropdownY + 6.0f}, 16, 1,
-               YELLOW);
+    const TextLayout& fallSpeedText = fallSpeedLabel.Get(font, fallSpeed, 16);
+    fallSpeedText.Draw({fallSpeedBoxX + 45.0f - fallSpeedText.GetSize().x / 2, dropdownY + 6.0f}, YELLOW);
 
     // Up/Down arrows for fallSpeed
     Rectangle fallUpBtn = {fallSpeedBoxX + 72.0f, dropdownY + 2.0f, 24.0f, 12.0f};
@@ -185,7 +198,7 @@ void PianoPage::Draw() {
     float channelDropdownHeight = 30;
     channelDropdownBox = {channelDropdownX, dropdownY, channelDropdownWidth, channelDropdownHeight};
     DrawRectangleRec(channelDropdownBox, DARKGRAY);
-    DrawTextEx(font, "Channels", {channelDropdownX + 10, dropdownY + 6}, 16, 1, WHITE);
+    textLayoutCache.Get(font, "Channels", 16).Draw({channelDropdownX + 10, dropdownY + 6}, WHITE);
     DrawTriangle(
         Vector2{channelDropdownX + channelDropdownWidth - 20, dropdownY + 12},
         Vector2{channelDropdownX + channelDropdownWidth - 10, dropdownY + 12},
@@ -200,8 +213,8 @@ void PianoPage::Draw() {
                 channelDropdownWidth, channelDropdownHeight
             };
             DrawRectangleRec(itemRect, channelMuteStates[ch] ? GRAY : DARKGRAY);
-            std::string label = "Channel " + std::to_string(ch + 1) + (channelMuteStates[ch] ? " (Muted)" : "");
-            DrawTextEx(font, label.c_str(), {channelDropdownX + 10, itemRect.y + 6}, 16, 1, WHITE);
+            const std::string& label = channelMuteStates[ch] ? mutedChannelLabels[ch] : channelLabels[ch];
+            textLayoutCache.Get(font, label, 16).Draw({channelDropdownX + 10, itemRect.y + 6}, WHITE);
 
             // Mute toggle box
             Rectangle muteBox = {itemRect.x + channelDropdownWidth - 40, itemRect.y + 6, 20, 20};
@@ -213,29 +226,60 @@ void PianoPage::Draw() {
     float progressBarY = 50;
     DrawRectangleRec({0, progressBarY, (float) windowWidth, 30}, GRAY);
     DrawLineEx({0, 82}, {(float) windowWidth, 81}, 1.0f, DARKGRAY);
-    long total_ticks = fluid_player_get_total_ticks(player);
-    long current_tick = fluid_player_get_current_tick(player);
-    double progress = (double) current_tick / (double) total_ticks;
+    double totalTime = tempoMap.TicksToSeconds(fluid_player_get_total_ticks(player));
+    double progress = totalTime > 0.0 ? std::clamp(currentTime / totalTime, 0.0, 1.0) : 0.0;
     DrawRectangleRec({0, progressBarY, (float) (progress * windowWidth), 30}, Color{165, 91, 254, 255});
+    // A-B loop region, or just its start while B is not set yet
+    if (loopStart >= 0.0 && totalTime > 0.0) {
+        float loopX = static_cast<float>(loopStart / totalTime * windowWidth);
+        if (loopEnd > loopStart) {
+            float loopWidth = static_cast<float>((loopEnd - loopStart) / totalTime * windowWidth);
+            DrawRectangleRec({loopX, progressBarY, loopWidth, 30}, Color{255, 220, 0, 90});
+        }
+        DrawRectangleRec({loopX - 1, progressBarY, 2, 30}, YELLOW);
+    }
+    if (!song || !song->complete) {
+        textLayoutCache.Get(font, "Loading...", 16).Draw({10, progressBarY + 6}, WHITE);
+    }
 
     // Dropdown
     DrawRectangleRec(dropdownBox, DARKGRAY);
-    DrawTextEx(font, loadedSongInfos[currentSongIndex].displayName.c_str(),
-               {dropdownX + 10, dropdownY + 6}, 16, 1, WHITE);
+    songTitle.Draw({dropdownX + 10, dropdownY + 6}, WHITE);
     DrawTriangle(
         Vector2{dropdownX + dropdownWidth - 20, dropdownY + 12},
         Vector2{dropdownX + dropdownWidth - 10, dropdownY + 12},
         Vector2{dropdownX + dropdownWidth - 15, dropdownY + 22},
         BLACK
     );
-    if (dropdownOpen) {
-        for (int i = 0; i < amountOfSongs; ++i) {
+    if (songBrowser.IsOpen()) {
+        // The list stops above the keyboard, so clicking a row never presses a key
+        songBrowser.Draw(font, dropdownBox, keyboardY - 10.0f, currentSongIndex);
+    }
+
+    // SoundFont dropdown, right of the channels
+    float soundFontDropdownX = channelDropdownX + channelDropdownWidth + 10;
+    float soundFontDropdownWidth = 200;
+    soundFontDropdownBox = {soundFontDropdownX, dropdownY, soundFontDropdownWidth, dropdownHeight};
+    DrawRectangleRec(soundFontDropdownBox, DARKGRAY);
+    int activeSoundFont = soundFonts.GetActive();
+    const std::string &soundFontLabel = soundFonts.IsLoading()
+                                            ? loadingSoundFontLabel
+                                            : activeSoundFont >= 0 ? soundFontLabels[activeSoundFont] : noSoundFontLabel;
+    textLayoutCache.Get(font, soundFontLabel, 16).Draw({soundFontDropdownX + 10, dropdownY + 6}, WHITE);
+    DrawTriangle(
+        Vector2{soundFontDropdownX + soundFontDropdownWidth - 20, dropdownY + 12},
+        Vector2{soundFontDropdownX + soundFontDropdownWidth - 10, dropdownY + 12},
+        Vector2{soundFontDropdownX + soundFontDropdownWidth - 15, dropdownY + 22},
+        BLACK
+    );
+    if (soundFontDropdownOpen) {
+        for (size_t i = 0; i < soundFontLabels.size(); ++i) {
             Rectangle itemRect = {
-                dropdownX, dropdownY + dropdownHeight + i * dropdownHeight, dropdownWidth, dropdownHeight
+                soundFontDropdownX, dropdownY + dropdownHeight + i * dropdownHeight, soundFontDropdownWidth,
+                dropdownHeight
             };
-            DrawRectangleRec(itemRect, (i == currentSongIndex) ? GRAY : DARKGRAY);
-            std::string display = loadedSongInfos[i].displayName + " - " + loadedSongInfos[i].artist;
-            DrawTextEx(font, display.c_str(), {dropdownX + 10, itemRect.y + 6}, 16, 1, WHITE);
+            DrawRectangleRec(itemRect, (static_cast<int>(i) == activeSoundFont) ? GRAY : DARKGRAY);
+            textLayoutCache.Get(font, soundFontLabels[i], 16).Draw({soundFontDropdownX + 10, itemRect.y + 6}, WHITE);
         }
     }
 
@@ -243,11 +287,10 @@ void PianoPage::Draw() {
     float playBtnWidth = 80, playBtnHeight = 30;
     float playBtnX = (windowWidth - playBtnWidth) / 2, playBtnY = 10;
     Rectangle playBtn = {playBtnX, playBtnY, playBtnWidth, playBtnHeight};
-    Texture2D icon = isPlaying ? pauseIcon : playIcon;
     float iconSize = 24;
     DrawTexturePro(
-        icon,
-        Rectangle{0, 0, (float) icon.width, (float) icon.height},
+        atlas->texture,
+        atlas->Region(isPlaying ? SPRITE_PAUSE : SPRITE_PLAY),
         Rectangle{
             playBtn.x + (playBtn.width - iconSize) / 2, playBtn.y + (playBtn.height - iconSize) / 2, iconSize, iconSize
         },
@@ -255,29 +298,80 @@ void PianoPage::Draw() {
         0.0f,
         WHITE
     );
+    perfHud.AddStageTime(PerfStage::Ui, PerfHud::Clock::now() - uiStart);
 
 
     // Piano keys
-    DrawLineEx({0, (float) (keyboardY + 1)}, {(float) windowWidth, (float) (keyboardY + 1)}, 3.0f, RED);
-    DrawPianoKeys(keys, keyWasPressed, synth, font, true, whiteKey, whiteKeyPressed, blackKey, blackKeyPressed,
-                  midiKeyStates);
+    {
+        ScopedTimer timer(PerfStage::Keys);
+        DrawLineEx({0, (float) (keyboardY + 1)}, {(float) windowWidth, (float) (keyboardY + 1)}, 3.0f, RED);
+        DrawPianoKeys(keyboardLayout, keyWasPressed, synth, font, true, *atlas, TakeKeySnapshot());
+        perfHud.CountDrawCalls(keyboardLayout.GetKeys().size() + 1);
+    }
 
+    latencyCalibration.Draw(font, windowWidth, 100);
+    perfHud.Draw(90);
     EndDrawing();
 }
 
 void PianoPage::HandleInput() {
     Vector2 mouse = GetMousePosition();
 
+    // Latency tap test; keys go to the song search while the browser is open
+    bool shortcuts = !songBrowser.IsOpen();
+    // Open lists cover the progress bar
+    bool listsOpen = songBrowser.IsOpen() || channelDropdownOpen || soundFontDropdownOpen;
+    if (shortcuts && IsKeyPressed(KEY_L)) {
+        if (latencyCalibration.IsActive()) {
+            latencyCalibration.Stop();
+        } else {
+            if (isPlaying) {
+                fluid_player_stop(player);
+                isPlaying = false;
+            }
+            latencyCalibration.Start();
+        }
+    }
+    if (shortcuts && latencyCalibration.IsActive() && IsKeyPressed(KEY_SPACE) && latencyCalibration.Tap()) {
+        double measured = latencyCalibration.GetMeasuredLatency();
+        audioConfig.calibrationMs = (measured - BufferLatencySeconds(audioConfig)) * 1000.0;
+        SaveAudioConfig(audioConfig);
+        latencyCalibration.Stop();
+        std::cout << "Measured output latency: " << OutputLatencySeconds(audioConfig) * 1000.0 << " ms" << std::endl;
+    }
+
+    // A-B practice loop: A marks the start, B the end, C clears it
+    if (shortcuts && IsKeyPressed(KEY_A)) {
+        loopStart = std::max(0.0, songTime);
+        if (loopEnd <= loopStart) loopEnd = -1.0;
+        frameScheduler.RequestRedraw();
+    }
+    if (shortcuts && IsKeyPressed(KEY_B) && loopStart >= 0.0 && songTime > loopStart) {
+        loopEnd = songTime;
+        SeekTo(loopStart);
+    }
+    if (shortcuts && IsKeyPressed(KEY_C)) {
+        loopStart = loopEnd = -1.0;
+        frameScheduler.RequestRedraw();
+    }
+
+    // Clicking the progress bar seeks
+    Rectangle progressBar = {0, 50, static_cast<float>(GetScreenWidth()), 30};
+    if (!listsOpen && IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mouse, progressBar)) {
+        double fraction = mouse.x / progressBar.width;
+        if (song) SeekTo(fraction * song->file.tempoMap.TicksToSeconds(fluid_player_get_total_ticks(player)));
+    }
+
     // Tempo up/down
     Rectangle upBtn = {dropdownX + 352, dropdownY + 2, 24, 12};
     Rectangle downBtn = {dropdownX + 352, dropdownY + 16, 24, 12};
     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
         if (CheckCollisionPointRec(mouse, upBtn)) {
             tempo += 1;
-            fluid_player_set_tempo(player, FLUID_PLAYER_TEMPO_EXTERNAL_BPM, tempo);
+            ApplyTempo();
         } else if (CheckCollisionPointRec(mouse, downBtn)) {
             if (tempo > 20) tempo -= 1;
-            fluid_player_set_tempo(player, FLUID_PLAYER_TEMPO_EXTERNAL_BPM, tempo);
+            ApplyTempo();
         }
     }
 
@@ -308,28 +402,34 @@ void PianoPage::HandleInput() {
         }
     }
 
-    // Dropdown
+    // Song browser
+    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON) && CheckCollisionPointRec(mouse, dropdownBox)) {
+        if (songBrowser.IsOpen()) {
+            songBrowser.Close();
+        } else {
+            songBrowser.Open(currentSongIndex);
+        }
+    } else if (songBrowser.IsOpen()) {
+        int picked = songBrowser.HandleInput(dropdownBox, keyboardLayout.GetKeyboardY() - 10.0f);
+        if (picked >= 0 && picked != currentSongIndex) ReloadSong(picked);
+    }
+
+    // SoundFont dropdown; the switch happens in the background and playback continues
     if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        if (CheckCollisionPointRec(mouse, dropdownBox)) {
-            dropdownOpen = !dropdownOpen;
-        } else if (dropdownOpen) {
-            for (int i = 0; i < amountOfSongs; ++i) {
+        int soundFontCount = static_cast<int>(soundFontLabels.size());
+        if (CheckCollisionPointRec(mouse, soundFontDropdownBox)) {
+            soundFontDropdownOpen = !soundFontDropdownOpen;
+        } else if (soundFontDropdownOpen) {
+            for (int i = 0; i < soundFontCount; ++i) {
                 Rectangle itemRect = {
-                    dropdownX, dropdownY + dropdownHeight + i * dropdownHeight, dropdownWidth, dropdownHeight
+                    soundFontDropdownBox.x, soundFontDropdownBox.y + soundFontDropdownBox.height * (i + 1),
+                    soundFontDropdownBox.width, soundFontDropdownBox.height
                 };
-                if (CheckCollisionPointRec(mouse, itemRect)) {
-                    if (currentSongIndex != i) {
-                        ReloadSong(i);
-                    }
-                    dropdownOpen = false;
+                if (CheckCollisionPointRec(mouse, itemRect) && i != soundFonts.GetActive()) {
+                    soundFonts.Request(i);
                 }
             }
-            if (!CheckCollisionPointRec(mouse, {
-                                            dropdownX, dropdownY + dropdownHeight, dropdownWidth,
-                                            dropdownHeight * amountOfSongs
-                                        })) {
-                dropdownOpen = false;
-            }
+            soundFontDropdownOpen = false;
         }
     }
 
@@ -363,25 +463,177 @@ void PianoPage::HandleInput() {
 }
 
 void PianoPage::Update() {
-    // No per-frame logic needed for now, but could update progress, animations, etc.
+    ScopedTimer timer(PerfStage::Update);
+    latencyCalibration.Update(synth);
+
+    // Key highlights follow the sound, not the synth
+    auto outputLatency = std::chrono::duration_cast<KeyEventQueue::Clock::duration>(
+        std::chrono::duration<double>(OutputLatencySeconds(audioConfig)));
+    midiKeyEvents.ApplyDue(midiKeyStates, KeyEventQueue::Clock::now() - outputLatency);
+    // Advance to the next song when this one ends; it is usually waiting in the standby player
+    if (isPlaying && fluid_player_get_status(player) == FLUID_PLAYER_DONE) {
+        ReloadSong((currentSongIndex + 1) % amountOfSongs);
+        fluid_player_play(player);
+        isPlaying = true;
+    }
+
+    // Held notes sound again once the player is at the new position; loops wait for that too
+    if (chaseCheckpoint != nullptr && !playbackClock.IsSeekPending()) ChaseHeldNotes();
+    if (isPlaying && loopEnd > loopStart && loopStart >= 0.0 && !playbackClock.IsSeekPending() && songTime >= loopEnd) {
+        SeekTo(loopStart);
+    }
+
+    bool redraw = isPlaying || latencyCalibration.IsActive();
+    if (std::shared_ptr<const MidiSong> published = songLoader.TakePublished()) {
+        song = std::move(published);
+        noteRenderer.Upload(*song, keyboardLayout);
+        // Load the song's instruments before its program changes reach the audio thread
+        soundFonts.Hold(song->file.programs);
+        redraw = true;
+    }
+    int soundFontState = soundFonts.IsLoading() ? -2 : soundFonts.GetActive();
+    if (soundFontState != shownSoundFontState) {
+        shownSoundFontState = soundFontState;
+        redraw = true;
+    }
+    // Live MIDI input and the tail of queued note-offs change keys while paused
+    KeyStates::Snapshot keys = TakeKeySnapshot();
+    if (redraw || keys.keys != lastKeys.keys) frameScheduler.RequestRedraw();
+    lastKeys = keys;
 }
 
+KeyStates::Snapshot PianoPage::TakeKeySnapshot() const {
+    KeyStates::Snapshot keys = midiKeyStates.TakeSnapshot();
+    keys |= liveKeyStates.TakeSnapshot();
+    return keys;
+}
 
 void PianoPage::ReloadSong(int songIndex) {
     if (currentSongIndex == songIndex) return;
     currentSongIndex = songIndex;
-    fluid_player_stop(player);
-    player = new_fluid_player(synth);
-    fluid_player_add(player, loadedMidiFiles[currentSongIndex].c_str());
-    fluid_player_set_playback_callback(player, midi_event_handler, synth);
+    songTitle.Build(font, loadedSongInfos[currentSongIndex].displayName, 16, 1.0f);
+    // The player gets the same mapped bytes the loader parses, so the file is read once
+    player = players.Activate(loadedMidiFiles[currentSongIndex], songLoader.OpenFile(currentSongIndex).get());
+    // The player doesn't reset the synth, so nothing the last song set carries over
+    ResetPlaybackChannels(synth);
+    ApplyChannelMutes();
     tempo = midiBpms[currentSongIndex];
-    fluid_player_set_tempo(player, FLUID_PLAYER_TEMPO_EXTERNAL_BPM, tempo);
+    ApplyTempo();
     isPlaying = false;
-
-    LoadMidiBlocks(loadedMidiFiles[currentSongIndex]);
-    ticksPerQuarter = GetTicksPerQuarterFromMidi(loadedMidiFiles[currentSongIndex]);
+    // The stopped player sends no note-offs, so drop whatever it left held
+    midiKeyEvents.Discard();
+    midiKeyStates.Clear();
+    playbackClock.Reset();
+    loopStart = loopEnd = -1.0;
+    chaseSong.reset();
+    chaseCheckpoint = nullptr;
+
+    // Blocks arrive through Update() once the loader has parsed them
+    song.reset();
+    int nextSongIndex = (currentSongIndex + 1) % amountOfSongs;
+    songLoader.Request(currentSongIndex);
+    songLoader.Prefetch(nextSongIndex);
+    songLoader.Prefetch((currentSongIndex - 1 + amountOfSongs) % amountOfSongs);
+    // The standby shares the prefetch's mapping, so switching to it only starts playback
+    players.PrepareStandby(loadedMidiFiles[nextSongIndex], songLoader.OpenFile(nextSongIndex).get());
 
     // Reset all key pressed states
     keyWasPressed.clear();
     ResetKeyPressedStates(keyWasPressed);
 }
+
+void PianoPage::ApplyChannelMutes() {
+    for (int channel = 0; channel < 16; ++channel) {
+        if (channelMuteStates[channel]) SetChannelMute(synth, channel, true);
+    }
+}
+
+void PianoPage::ApplyTempo() {
+    // The tempo box shows the song's initial BPM; the player keeps following the
+    // file's own tempo changes, scaled by the same ratio
+    fluid_player_set_tempo(player, FLUID_PLAYER_TEMPO_INTERNAL, TempoRatio());
+}
+
+double PianoPage::TempoRatio() const {
+    if (currentSongIndex < 0) return 1.0;
+    int baseTempo = midiBpms[currentSongIndex] > 0 ? midiBpms[currentSongIndex] : 120;
+    return static_cast<double>(tempo) / baseTempo;
+}
+
+void PianoPage::SeekTo(double seconds) {
+    // Checkpoints only cover the whole song once the full parse is in
+    if (!song || !song->complete) return;
+    seconds = std::max(0.0, seconds);
+    const SeekIndex::Checkpoint* checkpoint = song->file.seekIndex.At(seconds);
+    if (checkpoint == nullptr) return;
+
+    // The player lands exactly on the target; the checkpoint before it only
+    // supplies the channel state and the notes held there.
+    // A seek the player has not applied yet makes it refuse a new one.
+    const TempoMap& tempoMap = song->file.tempoMap;
+    int targetTick = static_cast<int>(std::floor(tempoMap.SecondsToTicks(seconds)));
+    if (fluid_player_seek(player, targetTick) != FLUID_OK) return;
+    // Nothing from the old position keeps sounding. When the player applies the
+    // seek it replays the song's controller, program and pitch bend messages up
+    // to the new position, but it never undoes what only later parts of the song
+    // set; restoring the checkpoint first gives the replay a clean start. The
+    // replay also brings back the song's own volume, so mutes are applied again
+    // once it is done, in ChaseHeldNotes.
+    for (int channel = 0; channel < 16; ++channel) fluid_synth_all_sounds_off(synth, channel);
+    RestoreChannelStates(synth, *checkpoint);
+    ApplyChannelMutes();
+    midiKeyEvents.Discard();
+    midiKeyStates.Clear();
+    chaseSeconds = tempoMap.TicksToSeconds(targetTick);
+    playbackClock.Seek(chaseSeconds);
+    chaseSong = song;
+    chaseCheckpoint = checkpoint;
+    frameScheduler.RequestRedraw();
+}
+
+void PianoPage::ChaseHeldNotes() {
+    const SeekIndex::Checkpoint& checkpoint = *chaseCheckpoint;
+    const MidiFileData& file = chaseSong->file;
+    chaseCheckpoint = nullptr;
+
+    // The player's replay set each channel's volume from the song, over the mutes
+    ApplyChannelMutes();
+
+    // Key changes queued since the seek may still be from the old position
+    midiKeyEvents.Discard();
+    midiKeyStates.Clear();
+
+    // The player sounds the notes from the seek target on; the chase sounds the
+    // ones that started before it and are still held. Notes that end before the
+    // chase can reach the synth are left out, so a note-off never arrives ahead
+    // of its note-on.
+    double now = file.tempoMap.TicksToSeconds(fluid_player_get_current_tick(player));
+    double minEndTime = now + CHASE_MARGIN_SECONDS;
+    double minEndTick = file.tempoMap.SecondsToTicks(minEndTime);
+    for (const SeekIndex::HeldNote& note : file.seekIndex.HeldNotes(checkpoint)) {
+        if (static_cast<double>(note.endTick) > minEndTick) {
+            fluid_synth_noteon(synth, note.channel, note.key, note.velocity);
+        }
+    }
+    // Notes started between the checkpoint and the target come from the note
+    // store, which keeps no velocities
+    const NoteStore& notes = file.notes;
+    const float* startTimes = notes.StartTimes();
+    size_t first = std::lower_bound(startTimes, startTimes + notes.Size(), static_cast<float>(checkpoint.seconds)) -
+                   startTimes;
+    for (size_t i = first; i < notes.Size() && notes.StartTime(i) < chaseSeconds; ++i) {
+        if (notes.EndTime(i) > minEndTime) fluid_synth_noteon(synth, notes.Channel(i), notes.Key(i), CHASE_VELOCITY);
+    }
+
+    // Keys show every note held at the player's position, including any it started since the seek
+    const NoteIndex& index = chaseSong->noteIndex;
+    NoteIndex::Range range = index.Query(now, now);
+    auto lightKey = [&](size_t i) {
+        if (notes.StartTime(i) <= now && notes.EndTime(i) > now) {
+            midiKeyStates.SetKey(notes.Channel(i), notes.Key(i) - 21, true);
+        }
+    };
+    for (size_t pos = range.longFirst; pos < range.longLast; ++pos) lightKey(index.LongNote(pos));
+    for (size_t i = range.first; i < range.last; ++i) lightKey(i);
+    chaseSong.reset();
+}
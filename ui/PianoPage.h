@@ -1,22 +1,43 @@
 #pragma once
 
+#include <array>
+#include <memory>
 #include <vector>
 #include <string>
 #include <raylib.h>
 #include <fluidsynth.h>
 #include "../utils/SongInfo.h"
+#include "../utils/AudioConfig.h"
+#include "../utils/SoundFontManager.h"
 #include "../MidiLogic/MidiBlock.h"
+#include "../MidiLogic/KeyStates.h"
+#include "../MidiLogic/KeyEventQueue.h"
+#include "../MidiLogic/MidiSong.h"
+#include "../MidiLogic/SongLoader.h"
+#include "../MidiLogic/PlayerManager.h"
+#include "../MidiLogic/PlaybackClock.h"
 #include "PianoKey.h"
+#include "KeyboardLayout.h"
+#include "NoteRenderer.h"
+#include "LatencyCalibration.h"
+#include "BlockFrame.h"
+#include "TextLayout.h"
+#include "SongBrowser.h"
 
 class PianoPage {
 public:
     PianoPage(
         fluid_synth_t* synth,
-        fluid_player_t* player,
+        PlayerManager& players,
         std::vector<std::string>& loadedMidiFiles,
         std::vector<SongInfo>& loadedSongInfos,
         std::vector<int>& midiBpms,
-        std::vector<std::vector<bool>>& midiKeyStates
+        KeyStates& midiKeyStates,
+        KeyStates& liveKeyStates,
+        KeyEventQueue& midiKeyEvents,
+        AudioConfig& audioConfig,
+        PlaybackClock& playbackClock,
+        SoundFontManager& soundFonts
     );
     ~PianoPage();
 
@@ -33,7 +54,6 @@ private:
     int tempo;
     int currentSongIndex;
     int amountOfSongs;
-    bool dropdownOpen;
     bool isPlaying;
 
     // Falling blocks
@@ -45,24 +65,76 @@ private:
 
     // External dependencies
     fluid_synth_t* synth;
-    fluid_player_t* player;
+    PlayerManager& players;
+    fluid_player_t* player = nullptr; // Active player, owned by players
     std::vector<std::string>& loadedMidiFiles;
     std::vector<SongInfo>& loadedSongInfos;
     std::vector<int>& midiBpms;
-    std::vector<std::vector<bool>>& midiKeyStates;
+    KeyStates& midiKeyStates; // Keys of the song, from the player
+    KeyStates& liveKeyStates; // Keys played on MIDI input; never cleared by the page
+    KeyEventQueue& midiKeyEvents;
+    AudioConfig& audioConfig;
+    PlaybackClock& playbackClock;
+    SoundFontManager& soundFonts;
+    KeyStates::Snapshot lastKeys; // Keys held at the last Update(), to redraw when they change
     bool channelDropdownOpen = false;
     Rectangle channelDropdownBox;
     std::vector<bool> channelMuteStates = std::vector<bool>(16, false); // 16 MIDI channels
 
+    // Labels, laid out again only when their value changes
+    NumberLabel tempoLabel;
+    NumberLabel fallSpeedLabel;
+    TextLayout songTitle; // Rebuilt by ReloadSong, so titles don't pile up in textLayoutCache
+    std::array<std::string, 16> channelLabels;
+    std::array<std::string, 16> mutedChannelLabels;
+
+    // Song list under the song button
+    SongBrowser songBrowser;
+
+    // SoundFont dropdown
+    bool soundFontDropdownOpen = false;
+    Rectangle soundFontDropdownBox{};
+    std::vector<std::string> soundFontLabels;
+    std::string loadingSoundFontLabel = "Loading SoundFont...";
+    std::string noSoundFontLabel = "No SoundFont";
+    int shownSoundFontState = -1; // Active index, or -2 while loading, as last drawn
+
+    // Current song, replaced when the loader publishes a newer parse
+    SongLoader songLoader;
+    std::shared_ptr<const MidiSong> song;
+
+    // Seeking and the A-B practice loop, in song seconds
+    double songTime = 0.0; // Position heard at the last drawn frame
+    double loopStart = -1.0;
+    double loopEnd = -1.0;
+    // Notes held at the seek target, from the checkpoint before it, sound again
+    // once the player has applied the seek
+    std::shared_ptr<const MidiSong> chaseSong;
+    const SeekIndex::Checkpoint* chaseCheckpoint = nullptr;
+    double chaseSeconds = 0.0; // The seek target
+    static constexpr double CHASE_MARGIN_SECONDS = 0.1;
+    static constexpr int CHASE_VELOCITY = 96; // For notes after the checkpoint, whose velocity isn't stored
+
     // Resources
     Font font{};
-    Texture2D background{}, whiteKey{}, whiteKeyPressed{}, blackKey{}, blackKeyPressed{}, playIcon{}, pauseIcon{};
+    Texture2D background{};
+    const TextureAtlas* atlas = nullptr; // Key sprites and icons, owned by resourceCache
 
     // Piano keys
-    std::vector<PianoKey> keys;
+    KeyboardLayout keyboardLayout;
+    NoteRenderer noteRenderer;
+    std::vector<BlockQuad> blockQuads; // Reused by the CPU fallback
     std::vector<bool> keyWasPressed;
 
+    LatencyCalibration latencyCalibration;
+
+    KeyStates::Snapshot TakeKeySnapshot() const;
     void ReloadSong(int songIndex);
+    void SeekTo(double seconds);
+    void ChaseHeldNotes();
+    void ApplyChannelMutes();
+    void ApplyTempo();
+    double TempoRatio() const; // Song seconds per real second
     void LoadResources();
     void UnloadResources();
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+// ResourceCache.cpp
+#include "ResourceCache.h"
+#include "TextLayout.h"
+#include "../utils/FileUtils.h"
+
+#include <algorithm>
+
+ResourceCache resourceCache;
+
+namespace {
+    size_t TextureBytes(const Texture2D& texture) {
+        size_t bytes = GetPixelDataSize(texture.width, texture.height, texture.format);
+        // A full mip chain adds a third
+        return texture.mipmaps > 1 ? bytes + bytes / 3 : bytes;
+    }
+}
+
+Font ResourceCache::AcquireFont(const std::string& name) {
+    Entry<Font>& entry = fonts[name];
+    if (entry.references++ == 0) {
+        entry.asset = LoadFontEx(GetResourcePath(name).c_str(), FONT_SIZE, nullptr, 0);
+        GenTextureMipmaps(&entry.asset.texture);
+        SetTextureFilter(entry.asset.texture, TEXTURE_FILTER_TRILINEAR);
+    }
+    return entry.asset;
+}
+
+void ResourceCache::ReleaseFont(const std::string& name) {
+    auto it = fonts.find(name);
+    if (it == fonts.end() || --it->second.references > 0) return;
+    textLayoutCache.Forget(it->second.asset);
+    UnloadFont(it->second.asset);
+    fonts.erase(it);
+}
+
+Texture2D ResourceCache::AcquireTexture(const std::string& name) {
+    Entry<Texture2D>& entry = textures[name];
+    if (entry.references++ == 0) {
+        entry.asset = LoadTexture(GetResourcePath(name).c_str());
+    }
+    return entry.asset;
+}
+
+void ResourceCache::ReleaseTexture(const std::string& name) {
+    auto it = textures.find(name);
+    if (it == textures.end() || --it->second.references > 0) return;
+    UnloadTexture(it->second.asset);
+    textures.erase(it);
+}
+
+const TextureAtlas& ResourceCache::AcquireAtlas(const std::string& name, const std::vector<std::string>& sprites) {
+    Entry<TextureAtlas>& entry = atlases[name];
+    if (entry.references++ == 0) {
+        std::vector<std::string> paths;
+        for (const std::string& resource : sprites) paths.push_back(GetResourcePath(resource));
+        entry.asset = BuildTextureAtlas(paths);
+    }
+    return entry.asset;
+}
+
+void ResourceCache::ReleaseAtlas(const std::string& name) {
+    auto it = atlases.find(name);
+    if (it == atlases.end() || --it->second.references > 0) return;
+    UnloadTexture(it->second.asset.texture);
+    atlases.erase(it);
+}
+
+std::vector<ResourceCache::AssetMemory> ResourceCache::GetMemoryReport() const {
+    std::vector<AssetMemory> report;
+    for (const auto& [name, entry] : fonts) report.push_back({name, TextureBytes(entry.asset.texture), entry.references});
+    for (const auto& [name, entry] : textures) report.push_back({name, TextureBytes(entry.asset), entry.references});
+    for (const auto& [name, entry] : atlases) {
+        report.push_back({name, TextureBytes(entry.asset.texture), entry.references});
+    }
+    std::sort(report.begin(), report.end(), [](const AssetMemory& a, const AssetMemory& b) {
+        return a.bytes > b.bytes;
+    });
+    return report;
+}
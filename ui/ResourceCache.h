@@ -0,0 +1,53 @@
+// ResourceCache.h
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include "raylib.h"
+#include "TextureAtlas.h"
+
+// GPU assets shared between pages. Each is loaded on its first Acquire and
+// unloaded when the last holder releases it. Names are relative to the app's
+// resource directory. Only used from the render thread.
+class ResourceCache {
+public:
+    // Fonts are rasterised once at a large size with mipmaps, so any text size
+    // scales down from the same texture
+    Font AcquireFont(const std::string& name);
+    void ReleaseFont(const std::string& name);
+
+    Texture2D AcquireTexture(const std::string& name);
+    void ReleaseTexture(const std::string& name);
+
+    // Sprites are resource names, and each one's region has its index in the
+    // list; they only matter on the first acquire
+    const TextureAtlas& AcquireAtlas(const std::string& name, const std::vector<std::string>& sprites);
+    void ReleaseAtlas(const std::string& name);
+
+    struct AssetMemory {
+        std::string name;
+        size_t bytes;
+        int references;
+    };
+
+    // GPU memory held by every loaded asset, largest first
+    std::vector<AssetMemory> GetMemoryReport() const;
+
+private:
+    static constexpr int FONT_SIZE = 128;
+
+    template<typename T>
+    struct Entry {
+        T asset;
+        int references = 0;
+    };
+
+    std::unordered_map<std::string, Entry<Font>> fonts;
+    std::unordered_map<std::string, Entry<Texture2D>> textures;
+    std::unordered_map<std::string, Entry<TextureAtlas>> atlases;
+};
+
+extern ResourceCache resourceCache;
@@ -0,0 +1,128 @@
+// SongBrowser.cpp
+#include "SongBrowser.h"
+#include "TextLayout.h"
+#include "FrameScheduler.h"
+
+#include <algorithm>
+#include <cmath>
+
+SongBrowser::SongBrowser(const std::vector<SongInfo>& songs) {
+    labels.reserve(songs.size());
+    for (const SongInfo& info : songs) labels.push_back(info.displayName + " - " + info.artist);
+    search.Build(songs);
+    results = search.Search("");
+}
+
+void SongBrowser::Open(int currentSong) {
+    open = true;
+    SetQuery("");
+    scroll = std::max(0, currentSong) * ROW_HEIGHT;
+}
+
+Rectangle SongBrowser::SearchRect(Rectangle anchor) const {
+    return {anchor.x, anchor.y + anchor.height, anchor.width, ROW_HEIGHT};
+}
+
+Rectangle SongBrowser::ListRect(Rectangle anchor, float maxBottom) const {
+    Rectangle searchRect = SearchRect(anchor);
+    float top = searchRect.y + searchRect.height;
+    float height = std::min(results.size() * ROW_HEIGHT, std::max(ROW_HEIGHT, maxBottom - top));
+    return {anchor.x, top, anchor.width, height};
+}
+
+void SongBrowser::SetQuery(std::string newQuery) {
+    query = std::move(newQuery);
+    results = search.Search(query);
+    scroll = 0.0f;
+    frameScheduler.RequestRedraw();
+}
+
+void SongBrowser::ClampScroll(float listHeight) {
+    float maxScroll = std::max(0.0f, results.size() * ROW_HEIGHT - listHeight);
+    scroll = std::clamp(scroll, 0.0f, maxScroll);
+}
+
+int SongBrowser::HandleInput(Rectangle anchor, float maxBottom) {
+    // Search field; characters arrive as codepoints
+    std::string newQuery = query;
+    for (int codepoint = GetCharPressed(); codepoint > 0; codepoint = GetCharPressed()) {
+        int bytes = 0;
+        const char* utf8 = CodepointToUTF8(codepoint, &bytes);
+        newQuery.append(utf8, bytes);
+    }
+    if ((IsKeyPressed(KEY_BACKSPACE) || IsKeyPressedRepeat(KEY_BACKSPACE)) && !newQuery.empty()) {
+        // Drop the whole last codepoint, not just its final byte
+        size_t last = newQuery.size() - 1;
+        while (last > 0 && (static_cast<unsigned char>(newQuery[last]) & 0xC0) == 0x80) --last;
+        newQuery.erase(last);
+    }
+    if (newQuery != query) SetQuery(std::move(newQuery));
+    if (IsKeyPressed(KEY_ENTER) && !results.empty()) {
+        open = false;
+        return results.front();
+    }
+
+    Rectangle list = ListRect(anchor, maxBottom);
+    Vector2 mouse = GetMousePosition();
+    float wheel = GetMouseWheelMove();
+    if (wheel != 0.0f && CheckCollisionPointRec(mouse, list)) {
+        scroll -= wheel * WHEEL_ROWS * ROW_HEIGHT;
+        frameScheduler.RequestRedraw();
+    }
+    ClampScroll(list.height);
+
+    if (!IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) return -1;
+    if (CheckCollisionPointRec(mouse, list)) {
+        // The row under the mouse follows from the scroll offset; no row is visited
+        size_t row = static_cast<size_t>((mouse.y - list.y + scroll) / ROW_HEIGHT);
+        if (row < results.size()) {
+            open = false;
+            return results[row];
+        }
+    } else if (!CheckCollisionPointRec(mouse, SearchRect(anchor))) {
+        open = false;
+    }
+    return -1;
+}
+
+void SongBrowser::Draw(const Font& font, Rectangle anchor, float maxBottom, int currentSong) const {
+    Rectangle searchRect = SearchRect(anchor);
+    DrawRectangleRec(searchRect, Color{50, 50, 50, 255});
+    if (query.empty()) {
+        textLayoutCache.Get(font, "Search...", 16).Draw({searchRect.x + 10, searchRect.y + 6}, GRAY);
+    } else {
+        // The query changes with every keystroke, so it is not worth caching
+        DrawTextEx(font, query.c_str(), Vector2{searchRect.x + 10, searchRect.y + 6}, 16, 1, WHITE);
+    }
+
+    Rectangle list = ListRect(anchor, maxBottom);
+    if (results.empty()) {
+        DrawRectangleRec(list, DARKGRAY);
+        textLayoutCache.Get(font, "No matches", 16).Draw({list.x + 10, list.y + 6}, GRAY);
+        return;
+    }
+
+    // Input clamps the scroll too, but the list may have been opened this frame
+    float contentHeight = results.size() * ROW_HEIGHT;
+    float offset = std::clamp(scroll, 0.0f, std::max(0.0f, contentHeight - list.height));
+    size_t first = static_cast<size_t>(offset / ROW_HEIGHT);
+    size_t last = std::min(results.size(), static_cast<size_t>(std::ceil((offset + list.height) / ROW_HEIGHT)));
+    BeginScissorMode(static_cast<int>(list.x), static_cast<int>(list.y), static_cast<int>(list.width),
+                     static_cast<int>(list.height));
+    for (size_t row = first; row < last; ++row) {
+        int song = results[row];
+        Rectangle itemRect = {list.x, list.y + row * ROW_HEIGHT - offset, list.width, ROW_HEIGHT};
+        DrawRectangleRec(itemRect, song == currentSong ? GRAY : DARKGRAY);
+        // Not cached: only a screenful is drawn, but a cached layout per row ever
+        // scrolled past would grow with the library
+        DrawTextEx(font, labels[song].c_str(), Vector2{itemRect.x + 10, itemRect.y + 6}, 16, 1, WHITE);
+    }
+    EndScissorMode();
+
+    // Scrollbar when the results do not fit
+    if (contentHeight > list.height) {
+        float thumbHeight = std::max(ROW_HEIGHT / 2, list.height * list.height / contentHeight);
+        float thumbY = list.y + (list.height - thumbHeight) * offset / (contentHeight - list.height);
+        DrawRectangleRec({list.x + list.width - SCROLLBAR_WIDTH, thumbY, SCROLLBAR_WIDTH, thumbHeight}, LIGHTGRAY);
+    }
+}
@@ -0,0 +1,45 @@
+// SongBrowser.h
+#pragma once
+
+#include <string>
+#include <vector>
+#include "raylib.h"
+#include "../utils/SongInfo.h"
+#include "../utils/SongSearch.h"
+
+// Scrollable song list with a search field, hanging below the song button.
+// Only the rows inside the viewport are laid out, drawn and hit-tested, so a
+// frame costs the same for ten songs or ten thousand.
+class SongBrowser {
+public:
+    explicit SongBrowser(const std::vector<SongInfo>& songs);
+
+    bool IsOpen() const { return open; }
+
+    // Opens with an empty search, scrolled to the current song
+    void Open(int currentSong);
+    void Close() { open = false; }
+
+    // Typing, scrolling and clicks; returns the picked song or -1. The list
+    // hangs from anchor and ends above maxBottom. Clicking outside closes it.
+    int HandleInput(Rectangle anchor, float maxBottom);
+
+    void Draw(const Font& font, Rectangle anchor, float maxBottom, int currentSong) const;
+
+private:
+    static constexpr float ROW_HEIGHT = 30.0f;
+    static constexpr float WHEEL_ROWS = 3.0f;
+    static constexpr float SCROLLBAR_WIDTH = 6.0f;
+
+    std::vector<std::string> labels;
+    SongSearch search;
+    std::string query;
+    std::vector<int> results; // Song indices for the current query
+    float scroll = 0.0f;      // Pixels scrolled from the first result
+    bool open = false;
+
+    Rectangle SearchRect(Rectangle anchor) const;
+    Rectangle ListRect(Rectangle anchor, float maxBottom) const;
+    void SetQuery(std::string newQuery);
+    void ClampScroll(float listHeight);
+};
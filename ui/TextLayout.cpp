@@ -0,0 +1,87 @@
+// TextLayout.cpp
+#include "TextLayout.h"
+
+TextLayoutCache textLayoutCache;
+
+void TextLayout::Build(const Font& requestedFont, std::string_view text, float fontSize, float spacing) {
+    // Same fallback and glyph placement as DrawTextEx
+    Font font = requestedFont.texture.id != 0 ? requestedFont : GetFontDefault();
+    texture = font.texture;
+    glyphs.clear();
+    size = MeasureTextEx(font, std::string(text).c_str(), fontSize, spacing);
+
+    float scale = fontSize / font.baseSize;
+    float padding = static_cast<float>(font.glyphPadding);
+    float x = 0.0f;
+    float y = 0.0f;
+    for (size_t i = 0; i < text.size();) {
+        int byteCount = 0;
+        int codepoint = GetCodepointNext(&text[i], &byteCount);
+        i += byteCount > 0 ? byteCount : 1;
+        if (codepoint == '\n') {
+            x = 0.0f;
+            y += fontSize + 2.0f; // raylib's default line spacing
+            continue;
+        }
+        int index = GetGlyphIndex(font, codepoint);
+        const Rectangle& rec = font.recs[index];
+        if (codepoint != ' ' && codepoint != '\t') {
+            glyphs.push_back({
+                Rectangle{rec.x - padding, rec.y - padding, rec.width + 2 * padding, rec.height + 2 * padding},
+                Rectangle{
+                    x + (font.glyphs[index].offsetX - padding) * scale,
+                    y + (font.glyphs[index].offsetY - padding) * scale,
+                    (rec.width + 2 * padding) * scale,
+                    (rec.height + 2 * padding) * scale
+                }
+            });
+        }
+        float advance = font.glyphs[index].advanceX != 0 ? font.glyphs[index].advanceX : rec.width;
+        x += advance * scale + spacing;
+    }
+}
+
+void TextLayout::Draw(Vector2 position, Color tint) const {
+    for (const Glyph& glyph : glyphs) {
+        Rectangle target = glyph.target;
+        target.x += position.x;
+        target.y += position.y;
+        DrawTexturePro(texture, glyph.source, target, Vector2{0, 0}, 0.0f, tint);
+    }
+}
+
+const TextLayout& TextLayoutCache::Get(const Font& font, std::string_view text, float fontSize, float spacing) {
+    Style* style = nullptr;
+    for (auto& candidate : styles) {
+        if (candidate.fontTexture == font.texture.id && candidate.fontSize == fontSize &&
+            candidate.spacing == spacing) {
+            style = &candidate;
+            break;
+        }
+    }
+    if (style == nullptr) {
+        styles.push_back({font.texture.id, fontSize, spacing, {}});
+        style = &styles.back();
+    }
+
+    auto it = style->layouts.find(text);
+    if (it == style->layouts.end()) {
+        it = style->layouts.emplace(std::string(text), TextLayout{}).first;
+        it->second.Build(font, text, fontSize, spacing);
+    }
+    return it->second;
+}
+
+void TextLayoutCache::Forget(const Font& font) {
+    std::erase_if(styles, [&](const Style& style) { return style.fontTexture == font.texture.id; });
+}
+
+const TextLayout& NumberLabel::Get(const Font& font, int newValue, float newFontSize, float spacing) {
+    if (newValue != value || font.texture.id != fontTexture || newFontSize != fontSize) {
+        value = newValue;
+        fontTexture = font.texture.id;
+        fontSize = newFontSize;
+        layout.Build(font, std::to_string(value), fontSize, spacing);
+    }
+    return layout;
+}
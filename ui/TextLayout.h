@@ -0,0 +1,73 @@
+// TextLayout.h
+#pragma once
+
+#include <climits>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "raylib.h"
+
+// A string laid out once: the font texture region and offset of every glyph,
+// and the measured extent. Drawing it is one DrawTexturePro per visible glyph,
+// with no UTF-8 decoding, glyph lookups or measuring.
+class TextLayout {
+public:
+    void Build(const Font& font, std::string_view text, float fontSize, float spacing);
+
+    Vector2 GetSize() const { return size; }
+
+    void Draw(Vector2 position, Color tint) const;
+
+private:
+    struct Glyph {
+        Rectangle source;
+        Rectangle target; // Relative to the text origin
+    };
+
+    Texture2D texture{};
+    std::vector<Glyph> glyphs;
+    Vector2 size{};
+};
+
+// Layouts of strings that repeat from frame to frame, keyed by text, font and size
+class TextLayoutCache {
+public:
+    const TextLayout& Get(const Font& font, std::string_view text, float fontSize, float spacing = 1.0f);
+
+    // Drops every layout of a font that is about to be unloaded
+    void Forget(const Font& font);
+
+    void Clear() { styles.clear(); }
+
+private:
+    // Lets lookups take a string_view without building a std::string
+    struct TextHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view text) const { return std::hash<std::string_view>{}(text); }
+    };
+
+    struct Style {
+        unsigned int fontTexture;
+        float fontSize;
+        float spacing;
+        std::unordered_map<std::string, TextLayout, TextHash, std::equal_to<>> layouts;
+    };
+
+    std::vector<Style> styles;
+};
+
+extern TextLayoutCache textLayoutCache;
+
+// A number shown as text, formatted and laid out again only when it changes
+class NumberLabel {
+public:
+    const TextLayout& Get(const Font& font, int value, float fontSize, float spacing = 1.0f);
+
+private:
+    int value = INT_MIN;
+    unsigned int fontTexture = 0;
+    float fontSize = 0.0f;
+    TextLayout layout;
+};
@@ -0,0 +1,75 @@
+// TextureAtlas.cpp
+#include "TextureAtlas.h"
+
+#include <algorithm>
+
+namespace {
+    constexpr int PADDING = 2;
+    constexpr int MIN_WIDTH = 512;
+    constexpr int WHITE_SIZE = 4;
+
+    struct Placement {
+        size_t sprite;
+        Image image;
+        int x = 0;
+        int y = 0;
+    };
+}
+
+TextureAtlas BuildTextureAtlas(const std::vector<std::string>& sprites) {
+    std::vector<Placement> placements;
+    int widest = WHITE_SIZE;
+    for (size_t sprite = 0; sprite < sprites.size(); ++sprite) {
+        Image image = LoadImage(sprites[sprite].c_str());
+        if (image.data == nullptr) continue;
+        ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8);
+        placements.push_back({sprite, image});
+        widest = std::max(widest, image.width);
+    }
+
+    // Tallest first, left to right in rows
+    std::sort(placements.begin(), placements.end(), [](const Placement& a, const Placement& b) {
+        return a.image.height > b.image.height;
+    });
+    int width = std::max(MIN_WIDTH, widest + 2 * PADDING);
+    int x = PADDING;
+    int y = PADDING;
+    int rowHeight = 0;
+    for (auto& placement : placements) {
+        if (x + placement.image.width + PADDING > width) {
+            x = PADDING;
+            y += rowHeight + PADDING;
+            rowHeight = 0;
+        }
+        placement.x = x;
+        placement.y = y;
+        x += placement.image.width + PADDING;
+        rowHeight = std::max(rowHeight, placement.image.height);
+    }
+    if (x + WHITE_SIZE + PADDING > width) {
+        x = PADDING;
+        y += rowHeight + PADDING;
+        rowHeight = 0;
+    }
+    int whiteX = x;
+    int whiteY = y;
+    int height = y + std::max(rowHeight, WHITE_SIZE) + PADDING;
+
+    TextureAtlas atlas;
+    atlas.regions.assign(sprites.size(), Rectangle{0, 0, 0, 0});
+    Image atlasImage = GenImageColor(width, height, BLANK);
+    for (auto& placement : placements) {
+        Rectangle source{0, 0, (float) placement.image.width, (float) placement.image.height};
+        Rectangle target{(float) placement.x, (float) placement.y, source.width, source.height};
+        ImageDraw(&atlasImage, placement.image, source, target, WHITE);
+        atlas.regions[placement.sprite] = target;
+        UnloadImage(placement.image);
+    }
+    ImageDrawRectangle(&atlasImage, whiteX, whiteY, WHITE_SIZE, WHITE_SIZE, WHITE);
+    // The centre texels, so filtering never picks up a neighbour
+    atlas.whiteRegion = {(float) whiteX + 1, (float) whiteY + 1, WHITE_SIZE - 2, WHITE_SIZE - 2};
+
+    atlas.texture = LoadTextureFromImage(atlasImage);
+    UnloadImage(atlasImage);
+    return atlas;
+}
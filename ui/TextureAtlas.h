@@ -0,0 +1,24 @@
+// TextureAtlas.h
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+#include "raylib.h"
+
+// Several sprites packed into one texture, so drawing any mix of them never
+// switches textures and raylib can batch it into a single draw call.
+struct TextureAtlas {
+    Texture2D texture{};
+    std::vector<Rectangle> regions; // Indexed like the sprite list the atlas was built from
+    Rectangle whiteRegion{}; // Solid white texels for SetShapesTexture
+
+    // Source rectangle of a sprite, or an empty one if it failed to load
+    Rectangle Region(size_t sprite) const {
+        return sprite < regions.size() ? regions[sprite] : Rectangle{0, 0, 0, 0};
+    }
+};
+
+// Loads the images at the given file paths and packs them with shelf packing.
+// A sprite's region has the index of its path. Needs an open window.
+TextureAtlas BuildTextureAtlas(const std::vector<std::string>& sprites);
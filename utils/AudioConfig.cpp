@@ -0,0 +1,57 @@
+// AudioConfig.cpp
+#include "AudioConfig.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+AudioConfig LoadAudioConfig(const std::string& path, fluid_settings_t* settings) {
+    AudioConfig config;
+    config.path = path;
+    fluid_settings_getint(settings, "audio.periods", &config.periods);
+    fluid_settings_getint(settings, "audio.period-size", &config.periodSize);
+    fluid_settings_getnum(settings, "synth.sample-rate", &config.sampleRate);
+
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t separator = line.find('=');
+        if (separator == std::string::npos) continue;
+        std::string key = line.substr(0, separator);
+        const char* value = line.c_str() + separator + 1;
+        if (key == "periods") {
+            config.periods = std::max(2, std::atoi(value));
+        } else if (key == "period-size") {
+            config.periodSize = std::max(64, std::atoi(value));
+        } else if (key == "sample-rate") {
+            config.sampleRate = std::max(8000.0, std::atof(value));
+        } else if (key == "calibration-ms") {
+            config.calibrationMs = std::atof(value);
+        }
+    }
+    return config;
+}
+
+void ApplyAudioConfig(fluid_settings_t* settings, const AudioConfig& config) {
+    fluid_settings_setint(settings, "audio.periods", config.periods);
+    fluid_settings_setint(settings, "audio.period-size", config.periodSize);
+    fluid_settings_setnum(settings, "synth.sample-rate", config.sampleRate);
+}
+
+bool SaveAudioConfig(const AudioConfig& config) {
+    std::ofstream file(config.path, std::ios::trunc);
+    if (!file) return false;
+    file << "periods=" << config.periods << '\n'
+            << "period-size=" << config.periodSize << '\n'
+            << "sample-rate=" << config.sampleRate << '\n'
+            << "calibration-ms=" << config.calibrationMs << '\n';
+    return static_cast<bool>(file);
+}
+
+double BufferLatencySeconds(const AudioConfig& config) {
+    return config.periods * config.periodSize / config.sampleRate;
+}
+
+double OutputLatencySeconds(const AudioConfig& config) {
+    return std::max(0.0, BufferLatencySeconds(config) + config.calibrationMs / 1000.0);
+}
@@ -0,0 +1,30 @@
+// AudioConfig.h
+#pragma once
+
+#include <string>
+#include <fluidsynth.h>
+
+// Audio buffer settings, stored as key=value lines:
+//   periods=2
+//   period-size=512
+//   sample-rate=44100
+//   calibration-ms=12.5
+struct AudioConfig {
+    std::string path;
+    int periods = 16;
+    int periodSize = 64;
+    double sampleRate = 44100.0;
+    double calibrationMs = 0.0; // Measured by the tap test, on top of the buffer latency
+};
+
+// Starts from the backend defaults in settings and overrides them with the file
+AudioConfig LoadAudioConfig(const std::string& path, fluid_settings_t* settings);
+
+// Must run before the synth and the audio driver are created
+void ApplyAudioConfig(fluid_settings_t* settings, const AudioConfig& config);
+
+bool SaveAudioConfig(const AudioConfig& config);
+
+// Time from the synth rendering a sample to the speakers playing it
+double BufferLatencySeconds(const AudioConfig& config);
+double OutputLatencySeconds(const AudioConfig& config);
@@ -6,6 +6,7 @@
 
 
 std::string GetResourcePath(const std::string &filename) {
+#ifdef __APPLE__
     CFBundleRef mainBundle = CFBundleGetMainBundle();
     CFURLRef resourcesURL = CFBundleCopyResourcesDirectoryURL(mainBundle);
     char path[PATH_MAX];
@@ -15,5 +16,6 @@ std::string GetResourcePath(const std::string &filename) {
         return fullPath;
     }
     CFRelease(resourcesURL);
+#endif
     return filename; // fallback
 }
\ No newline at end of file
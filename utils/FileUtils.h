@@ -5,6 +5,8 @@
 #pragma once
 
 #include <string>
+#ifdef __APPLE__
 #include <CoreFoundation/CoreFoundation.h>
+#endif
 
 std::string GetResourcePath(const std::string &filename);
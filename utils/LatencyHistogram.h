@@ -0,0 +1,53 @@
+// LatencyHistogram.h
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+// Equal buckets from 0 to rangeMs, the last one collecting everything above.
+// Recording is a single relaxed atomic add, so it is safe on real-time threads.
+class LatencyHistogram {
+public:
+    static constexpr int BUCKETS = 100;
+
+    explicit LatencyHistogram(double rangeMs = 50.0) : bucketMs(rangeMs / BUCKETS) {}
+
+    void Record(double milliseconds) {
+        int bucket = std::clamp(static_cast<int>(milliseconds / bucketMs), 0, BUCKETS - 1);
+        counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint64_t GetCount() const {
+        uint64_t total = 0;
+        for (const auto& count : counts) total += count.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // Upper edge of the bucket holding the given fraction of samples, in ms
+    double Percentile(double fraction) const {
+        std::array<uint64_t, BUCKETS> snapshot;
+        uint64_t total = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            snapshot[i] = counts[i].load(std::memory_order_relaxed);
+            total += snapshot[i];
+        }
+        if (total == 0) return 0.0;
+        uint64_t target = static_cast<uint64_t>(fraction * (total - 1)) + 1;
+        uint64_t seen = 0;
+        for (int i = 0; i < BUCKETS; ++i) {
+            seen += snapshot[i];
+            if (seen >= target) return (i + 1) * bucketMs;
+        }
+        return BUCKETS * bucketMs;
+    }
+
+    void Reset() {
+        for (auto& count : counts) count.store(0, std::memory_order_relaxed);
+    }
+
+private:
+    double bucketMs;
+    std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+};
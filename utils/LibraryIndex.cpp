@@ -0,0 +1,113 @@
+// LibraryIndex.cpp
+#include "LibraryIndex.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include "../MidiLogic/MidiParser.h"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+    const std::string CACHE_HEADER = "sonique-library-cache v1";
+
+    bool StatFile(const std::string& path, uint64_t& size, int64_t& modifiedTime) {
+        namespace fs = std::filesystem;
+        std::error_code error;
+        size = fs::file_size(path, error);
+        if (error) return false;
+        auto writeTime = fs::last_write_time(path, error);
+        if (error) return false;
+        modifiedTime = static_cast<int64_t>(writeTime.time_since_epoch().count());
+        return true;
+    }
+
+    // One tab-separated line per file: path, size, mtime, bpm, tpq, duration, notes, channels
+    std::unordered_map<std::string, SongMetadata> LoadCache(const std::string& cachePath) {
+        std::unordered_map<std::string, SongMetadata> cache;
+        std::ifstream file(cachePath);
+        std::string line;
+        if (!std::getline(file, line) || line != CACHE_HEADER) return cache;
+        while (std::getline(file, line)) {
+            std::vector<std::string> fields;
+            std::stringstream stream(line);
+            std::string field;
+            while (std::getline(stream, field, '\t')) fields.push_back(field);
+            if (fields.size() != 8) continue;
+
+            SongMetadata metadata;
+            metadata.path = fields[0];
+            metadata.fileSize = std::strtoull(fields[1].c_str(), nullptr, 10);
+            metadata.modifiedTime = std::strtoll(fields[2].c_str(), nullptr, 10);
+            metadata.bpm = std::atoi(fields[3].c_str());
+            metadata.ticksPerQuarter = std::atoi(fields[4].c_str());
+            metadata.durationSeconds = std::strtod(fields[5].c_str(), nullptr);
+            metadata.noteCount = std::strtoull(fields[6].c_str(), nullptr, 10);
+            metadata.channelMask = static_cast<uint16_t>(std::strtoul(fields[7].c_str(), nullptr, 10));
+            cache[metadata.path] = metadata;
+        }
+        return cache;
+    }
+
+    void SaveCache(const std::string& cachePath, const std::vector<SongMetadata>& entries) {
+        // Written next to the cache and renamed, so a crash never leaves half a file
+        std::string tempPath = cachePath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::trunc);
+            if (!file) return;
+            file << CACHE_HEADER << '\n';
+            for (const auto& metadata : entries) {
+                file << metadata.path << '\t' << metadata.fileSize << '\t' << metadata.modifiedTime << '\t'
+                        << metadata.bpm << '\t' << metadata.ticksPerQuarter << '\t' << metadata.durationSeconds << '\t'
+                        << metadata.noteCount << '\t' << metadata.channelMask << '\n';
+            }
+            if (!file) return;
+        }
+        std::error_code error;
+        std::filesystem::rename(tempPath, cachePath, error);
+    }
+
+    void ReadMetadata(SongMetadata& metadata) {
+        MappedFile file(metadata.path);
+        MidiFileData song = ParseMidiFile(file.Data(), file.Size(), {false});
+        if (!song.valid) return; // Keeps the defaults, like an unreadable tempo did before
+        metadata.bpm = static_cast<int>(song.stats.initialBpm);
+        metadata.ticksPerQuarter = song.ticksPerQuarter;
+        metadata.durationSeconds = song.stats.durationSeconds;
+        metadata.noteCount = song.stats.noteCount;
+        metadata.channelMask = song.stats.channelMask;
+    }
+}
+
+std::vector<SongMetadata> IndexMidiLibrary(const std::vector<std::string>& midiPaths, const std::string& cachePath) {
+    std::unordered_map<std::string, SongMetadata> cache = LoadCache(cachePath);
+
+    std::vector<SongMetadata> entries(midiPaths.size());
+    std::vector<size_t> stale;
+    for (size_t i = 0; i < midiPaths.size(); ++i) {
+        SongMetadata& metadata = entries[i];
+        metadata.path = midiPaths[i];
+        StatFile(metadata.path, metadata.fileSize, metadata.modifiedTime);
+
+        auto cached = cache.find(metadata.path);
+        if (cached != cache.end() && cached->second.fileSize == metadata.fileSize &&
+            cached->second.modifiedTime == metadata.modifiedTime) {
+            metadata = cached->second;
+        } else {
+            stale.push_back(i);
+        }
+    }
+
+    ThreadPool::Shared().ParallelFor(stale.size(), [&](size_t i) {
+        ReadMetadata(entries[stale[i]]);
+    });
+
+    if (!stale.empty() || cache.size() != entries.size()) {
+        SaveCache(cachePath, entries);
+    }
+    std::cout << "Indexed " << entries.size() << " MIDI files (" << stale.size() << " parsed)" << std::endl;
+    return entries;
+}
@@ -0,0 +1,23 @@
+// LibraryIndex.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SongMetadata {
+    std::string path;
+    uint64_t fileSize = 0;
+    int64_t modifiedTime = 0;
+    int bpm = 120;
+    int ticksPerQuarter = 480;
+    double durationSeconds = 0.0;
+    size_t noteCount = 0;
+    uint16_t channelMask = 0; // Bit per channel that plays at least one note
+};
+
+// Returns metadata for every MIDI file, in the same order as midiPaths. Entries
+// whose path, size and modification time match the cache file are reused; the
+// remaining files are parsed in parallel and the cache is rewritten.
+std::vector<SongMetadata> IndexMidiLibrary(const std::vector<std::string>& midiPaths, const std::string& cachePath);
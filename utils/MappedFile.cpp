@@ -0,0 +1,44 @@
+// MappedFile.cpp
+#include "MappedFile.h"
+
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string& path) {
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) return;
+    struct stat info{};
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view != MAP_FAILED) {
+            // Parsers read front to back
+            madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+            data = static_cast<const uint8_t*>(view);
+            size = static_cast<size_t>(info.st_size);
+            mapped = true;
+        }
+    }
+    close(fd);
+    if (mapped) return;
+#endif
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return;
+    fallback.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    if (fallback.empty()) return;
+    data = fallback.data();
+    size = fallback.size();
+}
+
+MappedFile::~MappedFile() {
+#ifndef _WIN32
+    if (mapped) munmap(const_cast<uint8_t*>(data), size);
+#endif
+}
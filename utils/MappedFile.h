@@ -0,0 +1,27 @@
+// MappedFile.h
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of a whole file. Uses mmap where available and falls back to
+// reading the file into memory otherwise.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    bool IsOpen() const { return data != nullptr; }
+    const uint8_t* Data() const { return data; }
+    size_t Size() const { return size; }
+
+private:
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+    bool mapped = false;
+    std::vector<uint8_t> fallback;
+};
@@ -1,18 +1,21 @@
 // utils/MidiUtils.cpp
 
 #include "MidiUtils.h"
-#include "../MidiLogic/MidiBlock.h"
+#include "../MidiLogic/NoteStore.h"
+#include "../MidiLogic/KeyStates.h"
+#include "../MidiLogic/KeyEventQueue.h"
+#include "../MidiLogic/MidiParser.h"
+#include "../MidiLogic/NoteIndex.h"
+#include "../MidiLogic/TempoMap.h"
+#include "MappedFile.h"
 #include <vector>
-#include <map>
-#include <fstream>
 #include <iostream>
 
 #define NOTE_OFF 0x80
 #define NOTE_ON  0x90
 
-class MidiBlock;
-extern std::vector<std::vector<bool> > midiKeyStates;
-extern std::vector<MidiBlock> midiBlocks;
+extern KeyStates midiKeyStates;
+extern KeyEventQueue midiKeyEvents;
 int ticksPerQuarter = 480;
 
 #include <fluidsynth.h>
@@ -24,10 +27,11 @@ int midi_event_handler(void *data, fluid_midi_event_t *event) {
 
     if (channel != 9 && key >= 21 && key <= 108) {
         int idx = key - 21;
+        // Queued so the UI can show the key when it is heard; applied now only if the queue is full
         if (type == NOTE_ON && fluid_midi_event_get_velocity(event) > 0) {
-            midiKeyStates[channel][idx] = true;
+            if (!midiKeyEvents.Push(channel, idx, true)) midiKeyStates.SetKey(channel, idx, true);
         } else if (type == NOTE_OFF || (type == NOTE_ON && fluid_midi_event_get_velocity(event) == 0)) {
-            midiKeyStates[channel][idx] = false;
+            if (!midiKeyEvents.Push(channel, idx, false)) midiKeyStates.SetKey(channel, idx, false);
         }
     }
 
@@ -36,36 +40,10 @@ int midi_event_handler(void *data, fluid_midi_event_t *event) {
 }
 
 int GetMidiInitialTempoBPM(const std::string &midiPath) {
-    std::ifstream file(midiPath, std::ios::binary);
-    if (!file) return -1;
-    unsigned char buf[4];
-    while (file.read((char *) buf, 1)) {
-        if (buf[0] == 0xFF) {
-            file.read((char *) buf, 1);
-            if (buf[0] == 0x51) {
-                file.read((char *) buf, 1);
-                if (buf[0] == 3) {
-                    file.read((char *) buf, 3);
-                    int mpqn = (buf[0] << 16) | (buf[1] << 8) | buf[2];
-                    if (mpqn > 0) return static_cast<int>(60000000.0 / mpqn);
-                }
-                break;
-            }
-        }
-    }
-    return -1;
-}
-
-
-// Helper to read variable-length quantity
-uint32_t readVarLen(std::ifstream &file) {
-    uint32_t value = 0;
-    unsigned char c;
-    do {
-        file.read((char *) &c, 1);
-        value = (value << 7) | (c & 0x7F);
-    } while (c & 0x80);
-    return value;
+    MappedFile file(midiPath);
+    MidiFileData song = ParseMidiFile(file.Data(), file.Size(), {false});
+    if (!song.valid) return -1;
+    return static_cast<int>(song.stats.initialBpm);
 }
 
 void SetChannelMute(fluid_synth_t* synth, int channel, bool mute) {
@@ -73,105 +51,55 @@ void SetChannelMute(fluid_synth_t* synth, int channel, bool mute) {
     fluid_synth_cc(synth, channel, 7, volume);
 }
 
-void LoadMidiBlocks(const std::string &midiPath) {
-    std::cout << "Loading MIDI blocks from: " << midiPath << std::endl;
-    midiBlocks.clear();
-    std::ifstream file(midiPath, std::ios::binary);
-    if (!file) return;
-
-    // Read header
-    char header[14];
-    file.read(header, 14);
-    if (std::string(header, 4) != "MThd") return;
-    uint16_t format = (header[8] << 8) | (header[9] & 0xFF);
-    uint16_t ntrks = (header[10] << 8) | (header[11] & 0xFF);
-    uint16_t division = (header[12] << 8) | (header[13] & 0xFF);
-    ticksPerQuarter = division;
-    double tempo = 500000.0; // default 120 BPM
-
-    std::cout << "Format: " << format << ", ntrks: " << ntrks << ", division: " << division << std::endl;
-
-    for (int t = 0; t < ntrks; ++t) {
-        char trkHeader[8];
-        file.read(trkHeader, 8);
-        if (file.gcount() < 8 || std::string(trkHeader, 4) != "MTrk") break;
-        uint32_t trkLen = (trkHeader[4] << 24) | ((trkHeader[5] & 0xFF) << 16) | ((trkHeader[6] & 0xFF) << 8) | (trkHeader[7] & 0xFF);
-        std::streampos trackEnd = file.tellg();
-        trackEnd += trkLen;
-
-        std::map<int, double> noteOnTimes[16]; // channel -> key -> time
-        uint8_t runningStatus = 0;
-        double absTicks = 0.0;
-
-        while (file.tellg() < trackEnd) {
-            uint32_t delta = readVarLen(file);
-            absTicks += delta;
-            double timeSec = (absTicks * tempo) / (ticksPerQuarter * 1000000.0);
-
-            uint8_t status;
-            file.read((char *) &status, 1);
-            if (status < 0x80) {
-                file.unget();
-                status = runningStatus;
-            } else {
-                runningStatus = status;
-            }
-
-            if ((status & 0xF0) == NOTE_ON || (status & 0xF0) == NOTE_OFF) {
-                uint8_t key, vel;
-                file.read((char *) &key, 1);
-                file.read((char *) &vel, 1);
-                int channel = status & 0x0F;
-                if ((status & 0xF0) == NOTE_ON && vel > 0) {
-                    noteOnTimes[channel][key] = timeSec;
-                } else {
-                    if (noteOnTimes[channel].count(key)) {
-                        if (channel != 9) { // Ignore drums
-                            double start = noteOnTimes[channel][key];
-                            double duration = timeSec - start;
-                            midiBlocks.emplace_back(
-                                key,
-                                channel,
-                                start,
-                                duration,
-                                MidiBlock::colorForChannel(channel)
-                            );
-                        }
-                        noteOnTimes[channel].erase(key);
-                    }
-                }
-            } else if (status == 0xFF) {
-                uint8_t metaType;
-                file.read((char *) &metaType, 1);
-                uint32_t len = readVarLen(file);
-                if (metaType == 0x51 && len == 3) {
-                    unsigned char tbuf[3];
-                    file.read((char *) tbuf, 3);
-                    tempo = (tbuf[0] << 16) | (tbuf[1] << 8) | tbuf[2];
-                } else {
-                    file.seekg(len, std::ios::cur);
-                }
-            } else if ((status & 0xF0) == 0xC0 || (status & 0xF0) == 0xD0) {
-                file.seekg(1, std::ios::cur);
-            } else {
-                file.seekg(2, std::ios::cur);
-            }
+void ResetPlaybackChannels(fluid_synth_t* synth) {
+    for (int channel = 0; channel < 16; ++channel) {
+        fluid_synth_all_sounds_off(synth, channel);
+        fluid_synth_cc(synth, channel, 64, 0);
+        // Reset All Controllers leaves volume and pan alone
+        fluid_synth_cc(synth, channel, 121, 0);
+        fluid_synth_cc(synth, channel, 7, 100);
+        fluid_synth_cc(synth, channel, 10, 64);
+        fluid_synth_pitch_bend(synth, channel, 8192);
+        fluid_synth_bank_select(synth, channel, channel == 9 ? 128 : 0);
+        fluid_synth_program_change(synth, channel, 0);
+    }
+}
+
+void RestoreChannelStates(fluid_synth_t* synth, const SeekIndex::Checkpoint& checkpoint) {
+    for (int channel = 0; channel < 16; ++channel) {
+        const SeekIndex::ChannelState& state = checkpoint.channels[channel];
+        fluid_synth_bank_select(synth, channel, state.bank);
+        fluid_synth_program_change(synth, channel, state.program);
+        fluid_synth_pitch_bend(synth, channel, state.pitchBend);
+        for (size_t i = 0; i < SeekIndex::CONTROLLERS.size(); ++i) {
+            fluid_synth_cc(synth, channel, SeekIndex::CONTROLLERS[i], state.controllers[i]);
         }
-        file.seekg(trackEnd);
     }
-    std::cout << "Loaded blocks: " << midiBlocks.size() << std::endl;
 }
 
+void LoadMidiBlocks(const uint8_t *data, size_t size) {
+    MidiFileData song = ParseMidiFile(data, size);
+    std::cout << "Format: " << song.format << ", ntrks: " << song.trackCount
+            << ", division: " << song.ticksPerQuarter << std::endl;
+    midiNotes = std::move(song.notes);
+    midiTempoMap = std::move(song.tempoMap);
+    ticksPerQuarter = song.ticksPerQuarter;
+    midiNoteIndex.Build(midiNotes);
+    std::cout << "Loaded notes: " << midiNotes.Size() << std::endl;
+}
+
+void LoadMidiBlocks(const std::string &midiPath) {
+    std::cout << "Loading MIDI blocks from: " << midiPath << std::endl;
+    MappedFile file(midiPath);
+    LoadMidiBlocks(file.Data(), file.Size());
+}
 
-int GetTicksPerQuarterFromMidi(const std::string& midiPath) {
-    std::ifstream file(midiPath, std::ios::binary);
-    if (!file) return 480; // default if file can't be opened
 
-    char header[14];
-    file.read(header, 14);
-    if (file.gcount() < 14) return 480;
+int GetTicksPerQuarterFromMidi(const std::string& midiPath) {
+    MappedFile file(midiPath);
+    if (file.Size() < 14) return 480; // default if file can't be opened
 
     // MIDI header: bytes 12-13 are ticks per quarter note (big endian)
-    int tpq = (static_cast<unsigned char>(header[12]) << 8) | static_cast<unsigned char>(header[13]);
-    return tpq;
-}
\ No newline at end of file
+    const uint8_t *header = file.Data();
+    return (header[12] << 8) | header[13];
+}
@@ -1,7 +1,10 @@
 #pragma once
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <fluidsynth.h>
+#include "../MidiLogic/SeekIndex.h"
 
 
 // Handles MIDI events for the synth
@@ -10,8 +13,20 @@ int midi_event_handler(void *data, fluid_midi_event_t *event);
 // Gets the initial tempo (BPM) from a MIDI file
 int GetMidiInitialTempoBPM(const std::string &midiPath);
 
+// Parses a whole MIDI file into midiNotes, midiTempoMap and midiNoteIndex
 void LoadMidiBlocks(const std::string& midiFilePath);
 
+// Same as above, for a file that is already in memory
+void LoadMidiBlocks(const uint8_t* data, size_t size);
+
 int GetTicksPerQuarterFromMidi(const std::string& midiPath);
 
-void SetChannelMute(fluid_synth_t* synth, int channel, bool mute);
\ No newline at end of file
+void SetChannelMute(fluid_synth_t* synth, int channel, bool mute);
+
+// Silences channels 0-15 and puts them back to the state a song starts from:
+// controllers and pitch bend reset, sustain up, default volume, and bank 0
+// program 0 (the drum bank on channel 10). Mutes have to be applied again after.
+void ResetPlaybackChannels(fluid_synth_t* synth);
+
+// Sets the program, restored controllers and pitch bend of channels 0-15 as they were at a seek checkpoint
+void RestoreChannelStates(fluid_synth_t* synth, const SeekIndex::Checkpoint& checkpoint);
\ No newline at end of file
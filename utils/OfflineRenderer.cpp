@@ -0,0 +1,94 @@
+// OfflineRenderer.cpp
+#include "OfflineRenderer.h"
+#include "SoundFontUtils.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <fluidsynth.h>
+
+namespace {
+    OfflineRenderResult RenderJob(fluid_settings_t* settings, fluid_synth_t* synth, int soundFontId,
+                                  const OfflineRenderJob& job, const OfflineRenderOptions& options) {
+        OfflineRenderResult result;
+        auto start = std::chrono::steady_clock::now();
+
+        // Each song starts from the same state, whatever the previous one left behind
+        fluid_synth_system_reset(synth);
+        SelectDefaultPrograms(synth, soundFontId);
+
+        fluid_player_t* player = new_fluid_player(synth);
+        if (player == nullptr || fluid_player_add(player, job.midiPath.c_str()) != FLUID_OK) {
+            if (player != nullptr) delete_fluid_player(player);
+            return result;
+        }
+        // The renderer reads the output name from the settings when it is created
+        fluid_settings_setstr(settings, "audio.file.name", job.wavPath.c_str());
+        fluid_file_renderer_t* renderer = new_fluid_file_renderer(synth);
+        if (renderer == nullptr) {
+            delete_fluid_player(player);
+            return result;
+        }
+
+        int periodSize = 64;
+        fluid_settings_getint(settings, "audio.period-size", &periodSize);
+        uint64_t blocks = 0;
+        fluid_player_play(player);
+        while (fluid_player_get_status(player) == FLUID_PLAYER_PLAYING) {
+            if (fluid_file_renderer_process_block(renderer) != FLUID_OK) break;
+            ++blocks;
+        }
+        uint64_t tailBlocks = static_cast<uint64_t>(options.tailSeconds * options.sampleRate / periodSize);
+        for (uint64_t i = 0; i < tailBlocks; ++i) {
+            if (fluid_file_renderer_process_block(renderer) != FLUID_OK) break;
+            ++blocks;
+        }
+
+        delete_fluid_file_renderer(renderer);
+        delete_fluid_player(player);
+
+        result.ok = true;
+        result.audioSeconds = static_cast<double>(blocks) * periodSize / options.sampleRate;
+        result.renderSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+}
+
+std::vector<OfflineRenderResult> RenderMidiFiles(const std::vector<OfflineRenderJob>& jobs,
+                                                 const OfflineRenderOptions& options) {
+    std::vector<OfflineRenderResult> results(jobs.size());
+    unsigned threads = options.threads != 0 ? options.threads : std::max(1u, std::thread::hardware_concurrency());
+    size_t workerCount = std::min<size_t>(threads, jobs.size());
+    std::atomic<size_t> nextJob{0};
+
+    // A pool of its own, sized to the request: the shared pool stops at one thread per
+    // core, and rendering can be asked for more. The calling thread is one of the workers.
+    ThreadPool pool(static_cast<unsigned>(std::max<size_t>(workerCount, 2) - 1));
+    pool.ParallelFor(workerCount, [&](size_t) {
+        // Workers the pool starts late may find the queue already drained
+        if (nextJob.load() >= jobs.size()) return;
+        fluid_settings_t* settings = new_fluid_settings();
+        fluid_settings_setnum(settings, "synth.sample-rate", options.sampleRate);
+        fluid_settings_setstr(settings, "audio.file.type", "wav");
+        // Player events must follow the rendered samples, not the wall clock
+        fluid_settings_setstr(settings, "player.timing-source", "sample");
+        fluid_settings_setint(settings, "synth.lock-memory", 0);
+        fluid_synth_t* synth = new_fluid_synth(settings);
+        int soundFontId = synth != nullptr ? LoadSoundFont(synth, options.soundFontPath, 1) : FLUID_FAILED;
+
+        if (soundFontId != FLUID_FAILED) {
+            for (size_t i = nextJob++; i < jobs.size(); i = nextJob++) {
+                results[i] = RenderJob(settings, synth, soundFontId, jobs[i], options);
+            }
+        } else {
+            std::cerr << "Could not load SoundFont: " << options.soundFontPath << std::endl;
+        }
+
+        if (synth != nullptr) delete_fluid_synth(synth);
+        delete_fluid_settings(settings);
+    });
+    return results;
+}
@@ -0,0 +1,29 @@
+// OfflineRenderer.h
+#pragma once
+
+#include <string>
+#include <vector>
+
+struct OfflineRenderJob {
+    std::string midiPath;
+    std::string wavPath;
+};
+
+struct OfflineRenderOptions {
+    std::string soundFontPath;
+    double sampleRate = 44100.0;
+    double tailSeconds = 2.0; // Rendered after the last event so reverb can ring out
+    unsigned threads = 0;     // 0 uses one worker per hardware core
+};
+
+struct OfflineRenderResult {
+    bool ok = false;
+    double audioSeconds = 0.0;
+    double renderSeconds = 0.0;
+};
+
+// Renders MIDI files to WAV as fast as the CPU allows. Every worker owns its
+// own synth with the SoundFont loaded once, and renders jobs one after another.
+// Results are in the same order as jobs.
+std::vector<OfflineRenderResult> RenderMidiFiles(const std::vector<OfflineRenderJob>& jobs,
+                                                 const OfflineRenderOptions& options);
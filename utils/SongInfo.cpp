@@ -4,8 +4,8 @@
 #include "SongInfo.h"
 #include <fstream>
 
-std::vector<SongInfo> LoadSongInfos(const std::string &infoFilePath) {
-    std::vector<SongInfo> songInfos;
+SongInfoMap LoadSongInfos(const std::string &infoFilePath) {
+    SongInfoMap songInfos;
     std::ifstream infoFile(infoFilePath);
     std::string line;
     // Skip header
@@ -18,7 +18,7 @@ std::vector<SongInfo> LoadSongInfos(const std::string &infoFilePath) {
             info.midiFile = line.substr(0, first);
             info.displayName = line.substr(first + 1, second - first - 1);
             info.artist = line.substr(second + 1);
-            songInfos.push_back(info);
+            songInfos.emplace(info.midiFile, info);
         }
     }
     return songInfos;
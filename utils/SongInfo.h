@@ -4,6 +4,7 @@
 
 #pragma once
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 struct SongInfo {
@@ -12,4 +13,7 @@ struct SongInfo {
     std::string artist;
 };
 
-std::vector<SongInfo> LoadSongInfos(const std::string& infoFilePath);
\ No newline at end of file
+// Song infos keyed by MIDI file name; the first row for a file wins
+using SongInfoMap = std::unordered_map<std::string, SongInfo>;
+
+SongInfoMap LoadSongInfos(const std::string& infoFilePath);
\ No newline at end of file
@@ -0,0 +1,118 @@
+// SongSearch.cpp
+#include "SongSearch.h"
+
+#include <algorithm>
+#include <numeric>
+
+namespace {
+    char Lower(char c) {
+        return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+    }
+
+    // ASCII letters and digits split words; other UTF-8 bytes are kept whole
+    bool IsWordChar(char c) {
+        return (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || static_cast<unsigned char>(c) >= 0x80;
+    }
+
+    std::string Normalize(std::string_view text) {
+        std::string lower(text);
+        for (char& c : lower) c = Lower(c);
+        return lower;
+    }
+
+    template<typename Fn>
+    void ForEachWord(std::string_view text, Fn&& fn) {
+        size_t i = 0;
+        while (i < text.size()) {
+            while (i < text.size() && !IsWordChar(text[i])) ++i;
+            size_t start = i;
+            while (i < text.size() && IsWordChar(text[i])) ++i;
+            if (i > start) fn(text.substr(start, i - start));
+        }
+    }
+
+    // The term's characters appear in text in the same order
+    bool IsSubsequence(std::string_view term, std::string_view text) {
+        size_t t = 0;
+        for (char c : text) {
+            if (c == term[t] && ++t == term.size()) return true;
+        }
+        return false;
+    }
+}
+
+void SongSearch::Build(const std::vector<SongInfo>& songs) {
+    words.clear();
+    songTexts.clear();
+    for (size_t i = 0; i < songs.size(); ++i) {
+        int song = static_cast<int>(i);
+        std::string title = Normalize(songs[i].displayName);
+        std::string artist = Normalize(songs[i].artist);
+        std::string file = Normalize(songs[i].midiFile.substr(0, songs[i].midiFile.find_last_of('.')));
+        ForEachWord(title, [&](std::string_view word) { words.push_back({std::string(word), song, true}); });
+        ForEachWord(artist, [&](std::string_view word) { words.push_back({std::string(word), song, false}); });
+        ForEachWord(file, [&](std::string_view word) { words.push_back({std::string(word), song, false}); });
+        songTexts.push_back(title + ' ' + artist + ' ' + file);
+    }
+    std::sort(words.begin(), words.end(), [](const Word& a, const Word& b) { return a.text < b.text; });
+
+    prefixTerms.assign(songs.size(), 0);
+    titlePrefix.assign(songs.size(), 0);
+    lastQuery.clear();
+    matches.resize(songs.size());
+    std::iota(matches.begin(), matches.end(), 0);
+    results = matches;
+}
+
+const std::vector<int>& SongSearch::Search(std::string_view rawQuery) {
+    std::string query = Normalize(rawQuery);
+    std::vector<std::string_view> terms;
+    ForEachWord(query, [&](std::string_view term) {
+        if (terms.size() < MAX_TERMS) terms.push_back(term);
+    });
+
+    // Matching only narrows as a query grows, so the previous matches are the
+    // candidates; anything else starts again from the whole library
+    if (lastQuery.empty() || !query.starts_with(lastQuery)) {
+        matches.resize(songTexts.size());
+        std::iota(matches.begin(), matches.end(), 0);
+    }
+    lastQuery = query;
+    if (terms.empty()) {
+        results = matches;
+        return results;
+    }
+    std::erase_if(matches, [&](int song) {
+        return !std::all_of(terms.begin(), terms.end(), [&](std::string_view term) {
+            return IsSubsequence(term, songTexts[song]);
+        });
+    });
+
+    // Prefix hits from the sorted word list: each term is one contiguous range
+    for (int song : matches) {
+        prefixTerms[song] = 0;
+        titlePrefix[song] = 0;
+    }
+    for (size_t t = 0; t < terms.size(); ++t) {
+        std::string_view term = terms[t];
+        auto it = std::lower_bound(words.begin(), words.end(), term, [](const Word& word, std::string_view value) {
+            return word.text < value;
+        });
+        for (; it != words.end() && it->text.starts_with(term); ++it) {
+            prefixTerms[it->song] |= 1u << t;
+            if (it->title) titlePrefix[it->song] = 1;
+        }
+    }
+
+    // A prefix hit is also a subsequence, so every song with one is in matches
+    uint32_t allTerms = terms.size() == 32 ? UINT32_MAX : (1u << terms.size()) - 1;
+    results.clear();
+    for (int tier = 0; tier < 3; ++tier) {
+        for (int song : matches) {
+            bool prefix = prefixTerms[song] == allTerms;
+            int songTier = prefix ? (titlePrefix[song] ? 0 : 1) : 2;
+            if (songTier == tier) results.push_back(song);
+        }
+    }
+    return results;
+}
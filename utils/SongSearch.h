@@ -0,0 +1,40 @@
+// SongSearch.h
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "SongInfo.h"
+
+// Search over the titles, artists and file names of the library. Each song's
+// text is lowercased and split into words once. A song matches when every
+// query word is a prefix of one of its words, or failing that when each query
+// word's letters appear in order in its text. Prefix matches on the title rank
+// first, then other prefix matches, then the fuzzy ones; ties keep library order.
+class SongSearch {
+public:
+    void Build(const std::vector<SongInfo>& songs);
+
+    // Matching song indices, best first; every song in order for an empty query.
+    // A query that extends the previous one only rechecks the previous matches,
+    // so typing stays cheap on large libraries.
+    const std::vector<int>& Search(std::string_view query);
+
+private:
+    static constexpr size_t MAX_TERMS = 32;
+
+    struct Word {
+        std::string text;
+        int song;
+        bool title;
+    };
+
+    std::vector<Word> words;            // Sorted by text, so a prefix is one range
+    std::vector<std::string> songTexts; // "title artist file", lowercased
+    std::string lastQuery;
+    std::vector<int> matches;           // Songs matching lastQuery, in library order
+    std::vector<int> results;
+    std::vector<uint32_t> prefixTerms;  // Per song, bit per query word matched as a prefix
+    std::vector<uint8_t> titlePrefix;   // Per song, a query word is a prefix of a title word
+};
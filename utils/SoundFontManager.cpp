@@ -0,0 +1,127 @@
+// SoundFontManager.cpp
+#include "SoundFontManager.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+void SoundFontManager::Configure(fluid_settings_t* settings) {
+    fluid_settings_setint(settings, "synth.dynamic-sample-loading", 1);
+    fluid_settings_setint(settings, "synth.midi-channels", PLAYBACK_CHANNELS + HOLD_CHANNELS);
+    // A reset at the start of each song would drop the held programs; the piano
+    // page resets the playback channels itself on every song change
+    fluid_settings_setint(settings, "player.reset-synth", 0);
+}
+
+SoundFontManager::SoundFontManager(fluid_synth_t* synth, std::vector<std::string> soundFonts)
+    : synth(synth), soundFonts(std::move(soundFonts)) {
+    worker = std::thread(&SoundFontManager::WorkerLoop, this);
+}
+
+SoundFontManager::~SoundFontManager() {
+    Stop();
+}
+
+void SoundFontManager::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    if (worker.joinable()) worker.join();
+}
+
+void SoundFontManager::Request(int index) {
+    if (index < 0 || index >= static_cast<int>(soundFonts.size())) return;
+    {
+        // Set together with the request, so the worker's clear cannot land first
+        std::lock_guard<std::mutex> lock(mutex);
+        requestedIndex = index;
+        loading.store(true, std::memory_order_release);
+    }
+    wake.notify_all();
+}
+
+void SoundFontManager::Hold(std::vector<MidiProgram> programs) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        held = std::move(programs);
+        heldChanged = true;
+    }
+    wake.notify_all();
+}
+
+void SoundFontManager::WorkerLoop() {
+    std::vector<MidiProgram> programs;
+    while (true) {
+        int index = -1;
+        bool holdChanged = false;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || requestedIndex >= 0 || heldChanged; });
+            if (stopping) return;
+            std::swap(index, requestedIndex);
+            if (heldChanged) {
+                programs = held;
+                heldChanged = false;
+                holdChanged = true;
+            }
+        }
+        if (index >= 0) {
+            Switch(index);
+            SelectHeld(programs);
+        } else if (holdChanged) {
+            SelectHeld(programs);
+        }
+    }
+}
+
+void SoundFontManager::Switch(int index) {
+    const std::string& path = soundFonts[index];
+    auto start = std::chrono::steady_clock::now();
+    int id = fluid_synth_sfload(synth, path.c_str(), 0);
+    if (id == FLUID_FAILED) {
+        std::cerr << "Failed to load SoundFont " << path << std::endl;
+        std::lock_guard<std::mutex> lock(mutex);
+        if (requestedIndex < 0) loading.store(false, std::memory_order_release);
+        return;
+    }
+
+    // Every channel keeps its instrument, taken from the new font; a preset
+    // the font lacks falls back to the first one of its bank type
+    for (int channel = 0; channel < PLAYBACK_CHANNELS; ++channel) {
+        int sfId = 0;
+        int bank = channel == 9 ? 128 : 0;
+        int program = 0;
+        if (activeId >= 0) fluid_synth_get_program(synth, channel, &sfId, &bank, &program);
+        if (fluid_synth_program_select(synth, channel, id, bank, program) != FLUID_OK &&
+            fluid_synth_program_select(synth, channel, id, bank >= 128 ? 128 : 0, 0) != FLUID_OK) {
+            fluid_synth_program_select(synth, channel, id, 0, 0);
+        }
+    }
+    if (activeId >= 0) fluid_synth_sfunload(synth, activeId, 0);
+    activeId = id;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "SoundFont " << path << " ready in " << seconds * 1000.0 << " ms" << std::endl;
+    activeIndex.store(index, std::memory_order_release);
+    std::lock_guard<std::mutex> lock(mutex);
+    if (requestedIndex < 0) loading.store(false, std::memory_order_release);
+}
+
+void SoundFontManager::SelectHeld(const std::vector<MidiProgram>& programs) {
+    if (activeId < 0) return;
+    size_t count = std::min(programs.size(), static_cast<size_t>(HOLD_CHANNELS));
+    if (count < programs.size()) {
+        std::cout << "Song uses " << programs.size() << " presets; " << programs.size() - count
+                  << " beyond the " << HOLD_CHANNELS << " held ones load when first played" << std::endl;
+    }
+    for (int slot = 0; slot < HOLD_CHANNELS; ++slot) {
+        int channel = PLAYBACK_CHANNELS + slot;
+        if (static_cast<size_t>(slot) < count) {
+            fluid_synth_program_select(synth, channel, activeId, programs[slot].bank, programs[slot].program);
+        } else {
+            fluid_synth_unset_program(synth, channel);
+        }
+    }
+}
@@ -0,0 +1,69 @@
+// SoundFontManager.h
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fluidsynth.h>
+#include "../MidiLogic/MidiParser.h"
+
+// Loads SoundFonts on a background thread and switches the synth between them.
+// Samples are loaded lazily: FluidSynth only keeps the samples of presets
+// selected on some channel. The current song's programs are held on extra
+// channels that never play, so their samples are read on this thread rather
+// than by the audio thread when the song's program changes arrive. There are
+// HOLD_CHANNELS of them, far more than songs use in practice; a song using
+// more distinct presets has the rest load on first use, which is logged.
+// A switch moves every channel to the new font before the old one is
+// unloaded; notes still sounding on the old font finish first.
+class SoundFontManager {
+public:
+    static constexpr int PLAYBACK_CHANNELS = 16;
+    static constexpr int HOLD_CHANNELS = 112; // Idle channels cost no rendering time
+
+    // Must run before the synth is created
+    static void Configure(fluid_settings_t* settings);
+
+    SoundFontManager(fluid_synth_t* synth, std::vector<std::string> soundFonts);
+    SoundFontManager(const SoundFontManager&) = delete;
+    SoundFontManager& operator=(const SoundFontManager&) = delete;
+    ~SoundFontManager();
+
+    // Switches to a SoundFont in the background, replacing any pending request
+    void Request(int index);
+
+    // Keeps these programs' samples loaded until the next call
+    void Hold(std::vector<MidiProgram> programs);
+
+    // Index of the SoundFont in use, or -1 until the first one has loaded
+    int GetActive() const { return activeIndex.load(std::memory_order_acquire); }
+    bool IsLoading() const { return loading.load(std::memory_order_acquire); }
+    const std::vector<std::string>& GetSoundFonts() const { return soundFonts; }
+
+    // Joins the worker; must run before the synth is deleted
+    void Stop();
+
+private:
+    fluid_synth_t* synth;
+    std::vector<std::string> soundFonts;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    int requestedIndex = -1;
+    bool heldChanged = false;
+    std::vector<MidiProgram> held;
+
+    // Worker state
+    int activeId = -1;
+    std::atomic<int> activeIndex{-1};
+    std::atomic<bool> loading{false};
+
+    void WorkerLoop();
+    void Switch(int index);
+    void SelectHeld(const std::vector<MidiProgram>& programs);
+};
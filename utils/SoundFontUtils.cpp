@@ -34,3 +34,10 @@ std::vector<std::string> ScanSoundFonts(const std::string& dirPath) {
 int LoadSoundFont(fluid_synth_t* synth, const std::string& sf2Path, int resetPresets) {
     return fluid_synth_sfload(synth, sf2Path.c_str(), resetPresets);
 }
+
+void SelectDefaultPrograms(fluid_synth_t* synth, int soundFontId) {
+    for (int i = 1; i < 16; ++i) {
+        if (i == 9) continue;
+        fluid_synth_program_select(synth, i, soundFontId, 0, 0);
+    }
+}
@@ -14,4 +14,7 @@ bool EnsureSoundFontDir(const std::string& dirPath);
 std::vector<std::string> ScanSoundFonts(const std::string& dirPath);
 
 // Loads a SoundFont into the synth, returns the SoundFont ID
-int LoadSoundFont(fluid_synth_t* synth, const std::string& sf2Path, int resetPresets = 1);
\ No newline at end of file
+int LoadSoundFont(fluid_synth_t* synth, const std::string& sf2Path, int resetPresets = 1);
+
+// Selects the first preset of a SoundFont on every melodic channel
+void SelectDefaultPrograms(fluid_synth_t* synth, int soundFontId);
\ No newline at end of file
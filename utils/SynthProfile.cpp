@@ -0,0 +1,72 @@
+// SynthProfile.cpp
+#include "SynthProfile.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <thread>
+
+namespace {
+    int ValidInterpolation(int points) {
+        if (points >= FLUID_INTERP_7THORDER) return FLUID_INTERP_7THORDER;
+        if (points >= FLUID_INTERP_4THORDER) return FLUID_INTERP_4THORDER;
+        return points >= FLUID_INTERP_LINEAR ? FLUID_INTERP_LINEAR : FLUID_INTERP_NONE;
+    }
+}
+
+SynthProfile LoadSynthProfile(const std::string& path) {
+    SynthProfile profile;
+    profile.path = path;
+    // One core stays free for the render loop and the song loader
+    int hardwareThreads = static_cast<int>(std::thread::hardware_concurrency());
+    profile.cpuCores = std::clamp(hardwareThreads - 1, 1, 4);
+
+    std::ifstream file(path);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t separator = line.find('=');
+        if (separator == std::string::npos) continue;
+        std::string key = line.substr(0, separator);
+        const char* value = line.c_str() + separator + 1;
+        if (key == "polyphony") {
+            profile.polyphony = std::clamp(std::atoi(value), 16, 65535);
+        } else if (key == "cpu-cores") {
+            profile.cpuCores = std::clamp(std::atoi(value), 1, 256);
+        } else if (key == "interpolation") {
+            profile.interpolation = ValidInterpolation(std::atoi(value));
+        } else if (key == "reverb") {
+            profile.reverb = std::atoi(value) != 0;
+        } else if (key == "chorus") {
+            profile.chorus = std::atoi(value) != 0;
+        } else if (key == "auto-tune") {
+            profile.autoTune = std::atoi(value) != 0;
+        }
+    }
+    return profile;
+}
+
+void ApplySynthProfile(fluid_settings_t* settings, const SynthProfile& profile) {
+    fluid_settings_setint(settings, "synth.polyphony", profile.polyphony);
+    fluid_settings_setint(settings, "synth.cpu-cores", profile.cpuCores);
+    fluid_settings_setint(settings, "synth.reverb.active", profile.reverb ? 1 : 0);
+    fluid_settings_setint(settings, "synth.chorus.active", profile.chorus ? 1 : 0);
+}
+
+void ApplySynthProfile(fluid_synth_t* synth, const SynthProfile& profile) {
+    fluid_synth_set_polyphony(synth, profile.polyphony);
+    fluid_synth_set_interp_method(synth, -1, profile.interpolation);
+    fluid_synth_reverb_on(synth, -1, profile.reverb ? 1 : 0);
+    fluid_synth_chorus_on(synth, -1, profile.chorus ? 1 : 0);
+}
+
+bool SaveSynthProfile(const SynthProfile& profile) {
+    std::ofstream file(profile.path, std::ios::trunc);
+    if (!file) return false;
+    file << "polyphony=" << profile.polyphony << '\n'
+            << "cpu-cores=" << profile.cpuCores << '\n'
+            << "interpolation=" << profile.interpolation << '\n'
+            << "reverb=" << (profile.reverb ? 1 : 0) << '\n'
+            << "chorus=" << (profile.chorus ? 1 : 0) << '\n'
+            << "auto-tune=" << (profile.autoTune ? 1 : 0) << '\n';
+    return static_cast<bool>(file);
+}
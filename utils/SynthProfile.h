@@ -0,0 +1,36 @@
+// SynthProfile.h
+#pragma once
+
+#include <string>
+#include <fluidsynth.h>
+
+// Synth rendering cost settings, stored as key=value lines:
+//   polyphony=256
+//   cpu-cores=4
+//   interpolation=4
+//   reverb=1
+//   chorus=1
+//   auto-tune=1
+// The values are the most the synth may use; with auto-tune on, SynthTuner
+// lowers them while the machine can't keep up.
+struct SynthProfile {
+    std::string path;
+    int polyphony = 256;
+    int cpuCores = 1;
+    int interpolation = FLUID_INTERP_4THORDER; // 0, 1, 4 or 7 points
+    bool reverb = true;
+    bool chorus = true;
+    bool autoTune = true;
+};
+
+// Starts from one core per hardware thread, up to four, and overrides it with the file
+SynthProfile LoadSynthProfile(const std::string& path);
+
+// Settings that are read when the synth is created
+void ApplySynthProfile(fluid_settings_t* settings, const SynthProfile& profile);
+
+// Settings that can change while the synth runs
+void ApplySynthProfile(fluid_synth_t* synth, const SynthProfile& profile);
+
+// Writes the profile back to its path
+bool SaveSynthProfile(const SynthProfile& profile);
@@ -0,0 +1,65 @@
+// SynthTuner.cpp
+#include "SynthTuner.h"
+
+#include <algorithm>
+#include <iostream>
+
+SynthTuner::SynthTuner(fluid_synth_t* synth, const SynthProfile& profile)
+    : synth(synth), enabled(profile.autoTune) {
+    // Every level is one step cheaper than the one before; steps that would
+    // change nothing for this profile are skipped
+    levels.push_back(profile);
+    auto addStep = [&](auto change) {
+        SynthProfile next = levels.back();
+        change(next);
+        const SynthProfile& last = levels.back();
+        if (next.chorus != last.chorus || next.reverb != last.reverb ||
+            next.interpolation != last.interpolation || next.polyphony != last.polyphony) {
+            levels.push_back(next);
+        }
+    };
+    addStep([](SynthProfile& p) { p.chorus = false; });
+    addStep([](SynthProfile& p) { p.reverb = false; });
+    addStep([](SynthProfile& p) { p.interpolation = std::min(p.interpolation, (int) FLUID_INTERP_LINEAR); });
+    for (int step = 0; step < 3; ++step) {
+        // Halving stops at 32 voices, and never raises a profile configured below that
+        addStep([](SynthProfile& p) { p.polyphony = std::min(p.polyphony, std::max(32, p.polyphony / 2)); });
+    }
+
+    ApplySynthProfile(synth, profile);
+    Clock::time_point now = Clock::now();
+    lastCheck = lastChange = quietSince = now;
+}
+
+void SynthTuner::Update(uint32_t lateBuffers) {
+    Clock::time_point now = Clock::now();
+    if (!enabled || std::chrono::duration<double>(now - lastCheck).count() < CHECK_SECONDS) return;
+    lastCheck = now;
+
+    uint32_t late = lateBuffers - lastLateBuffers;
+    lastLateBuffers = lateBuffers;
+    double load = fluid_synth_get_cpu_load(synth);
+    double sinceChange = std::chrono::duration<double>(now - lastChange).count();
+
+    if (late > 0 || load > HIGH_LOAD) {
+        quietSince = now;
+        if (level + 1 < GetLevelCount() && sinceChange >= STEP_DOWN_COOLDOWN) SetLevel(level + 1, now);
+    } else if (load >= LOW_LOAD) {
+        quietSince = now;
+    } else if (level > 0 && std::chrono::duration<double>(now - quietSince).count() >= STEP_UP_AFTER &&
+               sinceChange >= STEP_UP_AFTER) {
+        SetLevel(level - 1, now);
+        // The restored feature has to prove itself before the next one comes back
+        quietSince = now;
+    }
+}
+
+void SynthTuner::SetLevel(int newLevel, Clock::time_point now) {
+    level = newLevel;
+    lastChange = now;
+    const SynthProfile& profile = levels[level];
+    ApplySynthProfile(synth, profile);
+    std::cout << "Synth level " << level << "/" << GetLevelCount() - 1 << ": polyphony " << profile.polyphony
+            << ", interpolation " << profile.interpolation << ", reverb " << (profile.reverb ? "on" : "off")
+            << ", chorus " << (profile.chorus ? "on" : "off") << std::endl;
+}
@@ -0,0 +1,48 @@
+// SynthTuner.h
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include <fluidsynth.h>
+#include "SynthProfile.h"
+
+// Lowers the synth's rendering cost while the machine can't keep up and
+// raises it back once it has been comfortable for a while. Each level turns
+// off one more feature than the last: chorus, reverb, then cheaper
+// interpolation, then less polyphony. Underruns or a load above the limit
+// step down at once; a long quiet spell steps back up one level.
+class SynthTuner {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    SynthTuner(fluid_synth_t* synth, const SynthProfile& profile);
+
+    // Call every loop iteration with the audio driver's late buffer count;
+    // the synth is checked a few times per second
+    void Update(uint32_t lateBuffers);
+
+    int GetLevel() const { return level; }
+    int GetLevelCount() const { return static_cast<int>(levels.size()); }
+    const SynthProfile& GetCurrent() const { return levels[level]; }
+    uint32_t GetLateBuffers() const { return lastLateBuffers; }
+
+private:
+    static constexpr double CHECK_SECONDS = 0.5;
+    static constexpr double STEP_DOWN_COOLDOWN = 1.0;
+    static constexpr double STEP_UP_AFTER = 10.0; // Quiet time before a feature comes back
+    static constexpr double HIGH_LOAD = 85.0;     // Percent of real time
+    static constexpr double LOW_LOAD = 45.0;
+
+    fluid_synth_t* synth;
+    bool enabled;
+    std::vector<SynthProfile> levels;
+    int level = 0;
+
+    Clock::time_point lastCheck{};
+    Clock::time_point lastChange{};
+    Clock::time_point quietSince{};
+    uint32_t lastLateBuffers = 0;
+
+    void SetLevel(int newLevel, Clock::time_point now);
+};
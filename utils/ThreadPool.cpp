@@ -0,0 +1,97 @@
+// ThreadPool.cpp
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+    if (threadCount == 0) threadCount = std::max(1u, std::thread::hardware_concurrency());
+    workers.reserve(threadCount);
+    for (unsigned i = 0; i < threadCount; ++i) {
+        workers.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskAvailable.notify_all();
+    for (auto& worker : workers) worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    taskAvailable.notify_one();
+}
+
+void ThreadPool::Wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    idle.wait(lock, [this] { return tasks.empty() && runningTasks == 0; });
+}
+
+void ThreadPool::ParallelFor(size_t count, const std::function<void(size_t)>& fn) {
+    if (count == 0) return;
+    if (count == 1) {
+        fn(0);
+        return;
+    }
+
+    // Workers and the caller pull indices from a shared counter; the caller
+    // taking part means nested calls from a worker cannot deadlock
+    struct Job {
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+    auto job = std::make_shared<Job>();
+    auto drain = [job, count, &fn] {
+        size_t completed = 0;
+        for (size_t i = job->next++; i < count; i = job->next++) {
+            fn(i);
+            ++completed;
+        }
+        if (completed > 0 && job->done.fetch_add(completed) + completed == count) {
+            std::lock_guard<std::mutex> lock(job->mutex);
+            job->finished.notify_all();
+        }
+    };
+
+    size_t helpers = std::min<size_t>(workers.size(), count - 1);
+    for (size_t i = 0; i < helpers; ++i) Submit(drain);
+    drain();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->finished.wait(lock, [&] { return job->done.load() == count; });
+}
+
+ThreadPool& ThreadPool::Shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskAvailable.wait(lock, [this] { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty()) return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+            ++runningTasks;
+        }
+        task();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --runningTasks;
+            if (tasks.empty() && runningTasks == 0) idle.notify_all();
+        }
+    }
+}
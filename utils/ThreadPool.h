@@ -0,0 +1,45 @@
+// ThreadPool.h
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads pulling tasks from a shared queue
+class ThreadPool {
+public:
+    // 0 picks one thread per hardware core
+    explicit ThreadPool(unsigned threadCount = 0);
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    void Submit(std::function<void()> task);
+
+    // Blocks until the queue is empty and no task is running
+    void Wait();
+
+    // Runs fn(i) for every i in [0, count) on the workers and the calling
+    // thread, and returns once all of them finished
+    void ParallelFor(size_t count, const std::function<void(size_t)>& fn);
+
+    unsigned GetThreadCount() const { return static_cast<unsigned>(workers.size()); }
+
+    // Shared pool for short CPU-bound jobs such as parsing
+    static ThreadPool& Shared();
+
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskAvailable;
+    std::condition_variable idle;
+    size_t runningTasks = 0;
+    bool stopping = false;
+
+    void WorkerLoop();
+};